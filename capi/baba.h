@@ -0,0 +1,160 @@
+/**
+    @file baba.h
+    @brief Declares the C interface of the engine, for use from other languages.
+    @details Games are opaque handles created by baba_load or baba_clone and destroyed by baba_free.
+    Every output goes into caller-owned buffers, and stepping a game allocates nothing once its
+    buffers have reached the size of its largest state. No C++ exception crosses this interface:
+    functions report failures through their return value, and baba_last_error describes the last one.
+    A game must not be used by two threads at once, but different games can.
+*/
+
+#ifndef BABA_H
+#define BABA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #define BABA_API __declspec(dllexport)
+#else
+    #define BABA_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+    @brief An opaque game.
+*/
+typedef struct baba_game baba_game;
+
+/**
+    @brief The inputs of a step, in the order of UserInput.
+*/
+typedef enum baba_input {
+    BABA_UP, BABA_DOWN, BABA_LEFT, BABA_RIGHT,
+    BABA_RESET, BABA_UNDO, BABA_REDO, BABA_SAVE, BABA_QUIT,
+    BABA_NONE
+} baba_input;
+
+/**
+    @brief The return codes of the functions.
+*/
+typedef enum baba_status {
+    BABA_OK = 0,
+    BABA_INVALID_ARGUMENT = -1,
+    BABA_BUFFER_TOO_SMALL = -2
+} baba_status;
+
+/**
+    @brief An entity of a game, its type being a value of EntityType.
+*/
+typedef struct baba_entity {
+    int16_t row;
+    int16_t col;
+    uint8_t type;
+} baba_entity;
+
+/**
+    @brief Loads a game from a level held in memory, and applies its rules once.
+    @param level The level, in the format of the files of the levels directory; it needn't be null-terminated.
+    @param length The number of bytes of the level.
+    @return The game, or NULL if the level is invalid.
+*/
+BABA_API baba_game* baba_load(const char* level, size_t length);
+
+/**
+    @brief Copies a game, its starting map included.
+    @param game The game.
+    @return The copy, or NULL if game is NULL.
+*/
+BABA_API baba_game* baba_clone(const baba_game* game);
+
+/**
+    @brief Destroys a game; does nothing if game is NULL.
+    @param game The game.
+*/
+BABA_API void baba_free(baba_game* game);
+
+/**
+    @brief Advances a game by one input, as the game would after a key press.
+    @details UNDO, REDO and SAVE leave the map unchanged, as they need a history or the file system.
+    @param game The game.
+    @param input The input, a baba_input value.
+    @return BABA_OK, or BABA_INVALID_ARGUMENT if game is NULL or input is unknown.
+*/
+BABA_API int baba_step(baba_game* game, int input);
+
+/**
+    @brief Advances several games by one input each.
+    @param games The games, which must all be different.
+    @param inputs One input per game.
+    @param count The number of games.
+    @return BABA_OK, or BABA_INVALID_ARGUMENT if an argument is invalid, in which case no game was advanced.
+*/
+BABA_API int baba_step_batch(baba_game* const* games, const int* inputs, size_t count);
+
+/**
+    @brief Gets the size of the map of a game.
+    @param game The game.
+    @param rows Set to the number of rows.
+    @param cols Set to the number of columns.
+    @return BABA_OK, or BABA_INVALID_ARGUMENT if a pointer is NULL.
+*/
+BABA_API int baba_size(const baba_game* game, int* rows, int* cols);
+
+/**
+    @brief Tells whether a game is over, either won or quit.
+    @param game The game.
+    @return 1 if the game is over, 0 if it is not, or BABA_INVALID_ARGUMENT if game is NULL.
+*/
+BABA_API int baba_is_over(const baba_game* game);
+
+/**
+    @brief Gets the entity type controlled by the player.
+    @param game The game.
+    @return The EntityType value, NONE if no rule makes anything YOU, or BABA_INVALID_ARGUMENT if game is NULL.
+*/
+BABA_API int baba_player(const baba_game* game);
+
+/**
+    @brief Computes the Zobrist hash of the state of a game.
+    @param game The game.
+    @return The hash, 0 if game is NULL.
+*/
+BABA_API uint64_t baba_hash(const baba_game* game);
+
+/**
+    @brief Lists the types of the entities standing on a cell.
+    @param game The game.
+    @param row The row of the cell.
+    @param col The column of the cell.
+    @param types The buffer receiving the EntityType values, in map order.
+    @param capacity The number of elements of types.
+    @return The number of entities on the cell, written only if it is at most capacity, BABA_BUFFER_TOO_SMALL
+    otherwise, or BABA_INVALID_ARGUMENT if an argument is invalid.
+*/
+BABA_API int baba_cell(const baba_game* game, int row, int col, uint8_t* types, size_t capacity);
+
+/**
+    @brief Lists the entities of a game.
+    @param game The game.
+    @param entities The buffer receiving the entities, in map order; can be NULL to get their number.
+    @param capacity The number of elements of entities.
+    @return The number of entities, written only if it is at most capacity, BABA_BUFFER_TOO_SMALL
+    otherwise, or BABA_INVALID_ARGUMENT if game is NULL.
+*/
+BABA_API int baba_entities(const baba_game* game, baba_entity* entities, size_t capacity);
+
+/**
+    @brief Describes the last failure of the calling thread.
+    @return A null-terminated message, empty if nothing failed yet; valid until the next call on this thread.
+*/
+BABA_API const char* baba_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BABA_H
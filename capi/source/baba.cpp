@@ -0,0 +1,118 @@
+#include "../baba.h"
+#include "../../core/Map.h"
+#include "../../core/Simulation.h"
+#include <string>
+
+static_assert(BABA_NONE == static_cast<int>(UserInput::NONE), "baba_input must follow UserInput");
+
+struct baba_game {
+    Simulation::State initial;
+    Simulation::State state;
+
+    // state points to initial, which RESET restores
+    explicit baba_game(Simulation::State level) : initial{std::move(level)}, state{initial} { state.initial = &initial; }
+    baba_game(const baba_game& other) : initial{other.initial}, state{other.state} { state.initial = &initial; }
+};
+
+namespace {
+thread_local std::string lastError;
+
+int fail(int status, const char* message) {
+    lastError = message;
+    return status;
+}
+
+bool validInput(int input) { return input >= BABA_UP && input <= BABA_NONE; }
+}
+
+baba_game* baba_load(const char* level, size_t length) {
+    if(!level) { fail(BABA_INVALID_ARGUMENT, "No level"); return nullptr; }
+    try {
+        std::istringstream stream{std::string(level, length)};
+        baba_game* game{new baba_game{Simulation::fromMap(LevelLoader::parseLevel(stream, "level"))}};
+        Simulation::step(game->state, UserInput::NONE, game->state);
+        return game;
+    }
+    catch(const std::exception& e) {
+        fail(BABA_INVALID_ARGUMENT, e.what());
+        return nullptr;
+    }
+}
+
+baba_game* baba_clone(const baba_game* game) {
+    if(!game) { fail(BABA_INVALID_ARGUMENT, "No game"); return nullptr; }
+    try { return new baba_game{*game}; }
+    catch(const std::exception& e) {
+        fail(BABA_INVALID_ARGUMENT, e.what());
+        return nullptr;
+    }
+}
+
+void baba_free(baba_game* game) { delete game; }
+
+int baba_step(baba_game* game, int input) {
+    if(!game) { return fail(BABA_INVALID_ARGUMENT, "No game"); }
+    if(!validInput(input)) { return fail(BABA_INVALID_ARGUMENT, "Unknown input"); }
+    Simulation::step(game->state, static_cast<UserInput>(input), game->state);
+    return BABA_OK;
+}
+
+int baba_step_batch(baba_game* const* games, const int* inputs, size_t count) {
+    if(count && (!games || !inputs)) { return fail(BABA_INVALID_ARGUMENT, "No games or no inputs"); }
+    for(size_t i{}; i<count; ++i) {
+        if(!games[i]) { return fail(BABA_INVALID_ARGUMENT, "No game"); }
+        if(!validInput(inputs[i])) { return fail(BABA_INVALID_ARGUMENT, "Unknown input"); }
+    }
+    for(size_t i{}; i<count; ++i)
+        Simulation::step(games[i]->state, static_cast<UserInput>(inputs[i]), games[i]->state);
+    return BABA_OK;
+}
+
+int baba_size(const baba_game* game, int* rows, int* cols) {
+    if(!game || !rows || !cols) { return fail(BABA_INVALID_ARGUMENT, "Null argument"); }
+    *rows = game->state.rows;
+    *cols = game->state.cols;
+    return BABA_OK;
+}
+
+int baba_is_over(const baba_game* game) {
+    if(!game) { return fail(BABA_INVALID_ARGUMENT, "No game"); }
+    return game->state.gameOver;
+}
+
+int baba_player(const baba_game* game) {
+    if(!game) { return fail(BABA_INVALID_ARGUMENT, "No game"); }
+    return game->state.player;
+}
+
+uint64_t baba_hash(const baba_game* game) {
+    if(!game) { fail(BABA_INVALID_ARGUMENT, "No game"); return 0; }
+    return Simulation::hash(game->state);
+}
+
+int baba_cell(const baba_game* game, int row, int col, uint8_t* types, size_t capacity) {
+    if(!game || (capacity && !types)) { return fail(BABA_INVALID_ARGUMENT, "Null argument"); }
+    if(row < 0 || col < 0 || row >= game->state.rows || col >= game->state.cols) { return fail(BABA_INVALID_ARGUMENT, "Cell out of the map"); }
+    size_t count{};
+    for(const Simulation::Entity& entity : game->state.entities)
+        if(entity.row == row && entity.col == col) { ++count; }
+    if(count > capacity) { return fail(BABA_BUFFER_TOO_SMALL, "Buffer too small"); }
+    size_t written{};
+    for(const Simulation::Entity& entity : game->state.entities)
+        if(entity.row == row && entity.col == col) { types[written++] = entity.type; }
+    return static_cast<int>(count);
+}
+
+int baba_entities(const baba_game* game, baba_entity* entities, size_t capacity) {
+    if(!game) { return fail(BABA_INVALID_ARGUMENT, "No game"); }
+    const size_t count{game->state.entities.size()};
+    if(!entities) { return static_cast<int>(count); }
+    if(count > capacity) { return fail(BABA_BUFFER_TOO_SMALL, "Buffer too small"); }
+    for(size_t i{}; i<count; ++i) {
+        const Simulation::Entity& entity{game->state.entities[i]};
+        entities[i] = {entity.row, entity.col, entity.type};
+    }
+    return static_cast<int>(count);
+}
+
+const char* baba_last_error(void) { return lastError.c_str(); }
@@ -6,6 +6,8 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include <vector>
+
 // Forward declarations
 class Core;
 class View;
@@ -18,6 +20,7 @@ enum class UserInput;
 class Controller {
     Core* _core;
     View* _view;
+    bool _replayed{};
 public:
     /**
         @brief Constructs a new Controller object with the gis);iven Core and ViewWrapper objects.
@@ -28,6 +31,7 @@ public:
 
     /**
         @brief Starts the game loop for the Controller.
+        @details The model is updated first, unless a replay already did.
     */
     void start();
 
@@ -35,6 +39,16 @@ public:
         @brief Sends user input to the model
     */
     void manageInput(UserInput input);
+
+    /**
+        @brief Replays recorded inputs without redrawing the view after each of them.
+        @details The observers of the model are only notified every renderEvery inputs, and once the
+        replay is over, so a long replay is bound by the simulation rather than by the rendering.
+        The replay stops early if the game ends.
+        @param inputs The recorded inputs.
+        @param renderEvery The number of inputs between two redraws, 0 to only draw the final state.
+    */
+    void replay(const std::vector<UserInput>& inputs, unsigned renderEvery = 0);
 };
 
 #endif // CONTROLLER_H
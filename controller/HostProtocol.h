@@ -0,0 +1,148 @@
+/**
+    @file HostProtocol.h
+    @brief Defines the binary protocol spoken by SessionHost and a blocking client for it.
+*/
+
+#ifndef HOSTPROTOCOL_H
+#define HOSTPROTOCOL_H
+
+#include "../core/Utils.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <type_traits>
+#include <unistd.h>
+
+/**
+    @brief Namespace containing the messages exchanged with a SessionHost over a Unix domain socket.
+    @details Every request is a RequestHeader followed by its payload, and is answered by exactly one
+    Reply, in order. Both ends run on the same machine, so the integers are in native byte order.
+*/
+namespace HostProtocol {
+/**
+    @brief The kinds of requests.
+*/
+enum Opcode : std::uint8_t {
+    INPUTS = 1, // The payload holds one UserInput value per byte, from UP to REDO, played in order
+    HASH = 2, // No payload
+    RESTART = 3 // No payload, restarts the level even after the game ended
+};
+
+/**
+    @brief The header of a request.
+*/
+struct RequestHeader {
+    std::uint8_t opcode;
+    std::uint8_t reserved;
+    std::uint16_t length;
+};
+
+/**
+    @brief The answer to a request.
+*/
+struct Reply {
+    std::uint8_t opcode{}; // The opcode of the request, 0 if it was malformed or held an unplayable input
+    std::uint8_t gameOver{};
+    std::uint16_t played{}; // The number of inputs played before the game ended
+    std::uint32_t entities{};
+    std::uint64_t hash{};
+};
+
+static_assert(sizeof(RequestHeader) == 4 && sizeof(Reply) == 16);
+static_assert(std::is_trivially_copyable_v<RequestHeader> && std::is_trivially_copyable_v<Reply>);
+
+/**
+    @brief The largest number of inputs of a request.
+*/
+constexpr std::size_t MAX_INPUTS{UINT16_MAX};
+
+/**
+    @brief A blocking connection to a SessionHost.
+*/
+class Client {
+    int _socket;
+
+    void write(const void* data, std::size_t size) {
+        for(const char* bytes{static_cast<const char*>(data)}; size;) {
+            const ssize_t written{::send(_socket, bytes, size, MSG_NOSIGNAL)};
+            if(written <= 0) { throw std::runtime_error("Connection to the host lost"); }
+            bytes += written; size -= written;
+        }
+    }
+public:
+    /**
+        @brief Connects to a host, which starts a new game for this client.
+        @param path The path of the socket of the host.
+        @throws std::runtime_error If the host can't be reached.
+    */
+    explicit Client(const std::string& path) : _socket{::socket(AF_UNIX, SOCK_STREAM, 0)} {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if(_socket < 0 || path.size() >= sizeof(address.sun_path)) { throw std::runtime_error("Can't create a socket for "+path); }
+        std::strcpy(address.sun_path, path.c_str());
+        if(::connect(_socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(_socket);
+            throw std::runtime_error("Can't connect to "+path);
+        }
+    }
+    ~Client() { ::close(_socket); }
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    /**
+        @brief Sends a request without waiting for its reply, so that several requests can be pipelined.
+        @param opcode The kind of request.
+        @param inputs The inputs of an INPUTS request.
+        @param count The number of inputs, at most MAX_INPUTS.
+        @throws std::runtime_error If the connection is lost.
+    */
+    void send(Opcode opcode, const UserInput* inputs = nullptr, std::size_t count = 0) {
+        if(count > MAX_INPUTS) { throw std::invalid_argument("Too many inputs in one request"); }
+        char message[sizeof(RequestHeader) + 256];
+        const RequestHeader header{opcode, 0, static_cast<std::uint16_t>(count)};
+        std::memcpy(message, &header, sizeof(header));
+        std::size_t size{sizeof(header)};
+        for(std::size_t i{}; i<count; ++i) {
+            message[size++] = static_cast<char>(inputs[i]);
+            if(size == sizeof(message)) { write(message, size); size = 0; }
+        }
+        write(message, size);
+    }
+
+    /**
+        @brief Waits for the reply to the oldest request not answered yet.
+        @return The reply.
+        @throws std::runtime_error If the connection is lost.
+    */
+    Reply receive() {
+        Reply reply;
+        char* bytes{reinterpret_cast<char*>(&reply)};
+        for(std::size_t size{}; size<sizeof(reply);) {
+            const ssize_t read{::recv(_socket, bytes + size, sizeof(reply) - size, 0)};
+            if(read <= 0) { throw std::runtime_error("Connection to the host lost"); }
+            size += read;
+        }
+        return reply;
+    }
+
+    /**
+        @brief Sends a request and waits for its reply.
+        @param opcode The kind of request.
+        @param inputs The inputs of an INPUTS request.
+        @param count The number of inputs, at most MAX_INPUTS.
+        @return The reply.
+        @throws std::runtime_error If the connection is lost.
+    */
+    Reply request(Opcode opcode, const UserInput* inputs = nullptr, std::size_t count = 0) {
+        send(opcode, inputs, count);
+        return receive();
+    }
+};
+};
+
+#endif // HOSTPROTOCOL_H
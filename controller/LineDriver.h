@@ -0,0 +1,60 @@
+/**
+    @file LineDriver.h
+    @brief Defines the LineDriver class, which lets another process play the game through a line protocol.
+*/
+
+#ifndef LINEDRIVER_H
+#define LINEDRIVER_H
+
+#include "../core/MapSnapshot.h"
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class Core;
+
+/**
+    @brief Drives a Core with text commands, one per line, each answered by one line.
+    @details The commands are:
+    - a string of input characters (see charToInput, '.' and 'S' being NONE), played in order until
+      the game ends, answered by "OK <inputs played> <hash> <game over>";
+    - "reset", which restores the start of the level, even after the game ended, answered like inputs;
+    - "hash", answered by the hash of the state;
+    - "dump", answered by "<rows> <cols> <entity count>" followed by "<name> <row> <col>" for every entity;
+    - "quit", which ends the session without answer.
+    Hashes are written in hexadecimal, and a malformed command is answered by "ERR <reason>".
+    Replies are only flushed once every buffered command has been answered, so a client writing
+    many commands before reading their replies pays one round trip for all of them.
+*/
+class LineDriver {
+    std::unique_ptr<Core> _core;
+    MapSnapshot _start;
+    std::string _reply;
+
+    void playInputs(std::string_view inputs);
+public:
+    /**
+        @brief Loads a level.
+        @param level The path of the level.
+        @throws std::invalid_argument If the level can't be loaded.
+    */
+    explicit LineDriver(const std::string& level);
+    ~LineDriver();
+
+    /**
+        @brief Executes a command.
+        @param command The command, without its end of line.
+        @return The reply, without its end of line; valid until the next command.
+    */
+    const std::string& execute(std::string_view command);
+
+    /**
+        @brief Answers the commands read from a stream until it ends or a "quit" command.
+        @param in The stream of commands.
+        @param out The stream the replies are written to.
+    */
+    void run(std::istream& in, std::ostream& out);
+};
+
+#endif // LINEDRIVER_H
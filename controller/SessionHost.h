@@ -0,0 +1,97 @@
+/**
+    @file SessionHost.h
+    @brief Defines the SessionHost class, which hosts one game per client connected to a Unix domain socket.
+*/
+
+#ifndef SESSIONHOST_H
+#define SESSIONHOST_H
+
+#include "HostProtocol.h"
+#include "../core/MapSnapshot.h"
+#include "../utils/ThreadPool.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Core;
+
+/**
+    @brief Hosts many games in one process, one Core per connected client, speaking HostProtocol.
+    @details One thread polls the sockets and buffers what the clients sent. Then the sessions holding
+    complete requests are processed by the thread pool, each by a single thread, which plays its
+    requests in order and appends the replies to its output buffer. The polling thread sends the
+    replies before polling again. A session's requests are thus always played in order, while
+    different sessions are played in parallel.
+    A session whose replies pile up because its client stopped reading is not read from, nor
+    played, until its output drains. Clients can only move, undo, redo and reset: they can't
+    save, so the Cores of the sessions never start a save thread.
+*/
+class SessionHost {
+    struct Session {
+        int socket{-1};
+        std::unique_ptr<Core> core{};
+        MapSnapshot start{};
+        std::string input{};
+        std::string output{};
+        bool closed{};
+    };
+
+    std::string _path;
+    std::vector<std::string> _levels;
+    std::size_t _nextLevel{};
+    int _listener;
+    std::vector<std::unique_ptr<Session>> _sessions;
+    std::vector<Session*> _ready;
+    ThreadPool _pool;
+    std::atomic<bool> _stopping{};
+    std::atomic<std::size_t> _sessionCount{};
+    std::atomic<unsigned long long> _moves{};
+
+    void accept();
+    void receive(Session& session);
+    void process(Session& session);
+    void reply(Session& session, HostProtocol::Reply reply);
+    void send(Session& session);
+public:
+    /**
+        @brief Creates the socket and starts the worker threads.
+        @param path The path of the socket, replaced if it already exists.
+        @param levels The levels played by the clients, in turn.
+        @param threads The number of threads playing the games, 0 to use every core.
+        @throws std::invalid_argument If there is no level.
+        @throws std::runtime_error If the socket can't be created.
+    */
+    SessionHost(const std::string& path, const std::vector<std::string>& levels, std::size_t threads = 0);
+    /**
+        @brief Closes every connection and removes the socket.
+    */
+    ~SessionHost();
+
+    SessionHost(const SessionHost&) = delete;
+    SessionHost& operator=(const SessionHost&) = delete;
+
+    /**
+        @brief Serves the clients until stop() is called.
+    */
+    void run();
+
+    /**
+        @brief Makes run() return shortly; can be called from any thread.
+    */
+    void stop() { _stopping = true; }
+
+    /**
+        @brief Gets the number of connected clients.
+        @return The number of sessions.
+    */
+    std::size_t sessionCount() const { return _sessionCount; }
+
+    /**
+        @brief Gets the number of inputs played since the host started.
+        @return The number of inputs.
+    */
+    unsigned long long moveCount() const { return _moves; }
+};
+
+#endif // SESSIONHOST_H
@@ -8,7 +8,7 @@ Controller::Controller(Core* core, View* view) : _core(core), _view(view) {
 };
 
 void Controller::start() {
-    _core->update();
+    if(!_replayed) { _core->update(); }
     _view->start();
 }
 
@@ -16,3 +16,15 @@ void Controller::manageInput(UserInput input) {
     _core->manageInput(input);
     _core->update();
 }
+
+void Controller::replay(const std::vector<UserInput>& inputs, unsigned renderEvery) {
+    _replayed = true;
+    _core->setNotificationsSuspended(true);
+    _core->update();
+    for(std::size_t i{}; i<inputs.size() && !_core->isGameOver(); ++i) {
+        manageInput(inputs[i]);
+        if(renderEvery && (i+1) % renderEvery == 0) { _core->refreshObservers(); }
+    }
+    _core->setNotificationsSuspended(false);
+    _core->refreshObservers();
+}
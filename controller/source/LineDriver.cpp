@@ -0,0 +1,77 @@
+#include "../LineDriver.h"
+#include "../../core/Core.h"
+#include <charconv>
+#include <istream>
+#include <ostream>
+
+namespace {
+void appendNumber(std::string& reply, unsigned long long value, int base = 10) {
+    char buffer[24];
+    reply.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), value, base).ptr);
+}
+}
+
+LineDriver::LineDriver(const std::string& level) : _core{std::make_unique<Core>(level)} {
+    _core->update();
+    _start = _core->snapshot();
+}
+
+LineDriver::~LineDriver() = default;
+
+void LineDriver::playInputs(std::string_view inputs) {
+    unsigned long long played{};
+    for(char c : inputs) {
+        if(_core->isGameOver()) { break; }
+        // A client never writes save files: S is played like '.'
+        const UserInput input{charToInput(c)};
+        _core->manageInput(input == UserInput::SAVE ? UserInput::NONE : input);
+        _core->update();
+        ++played;
+    }
+    _reply = "OK ";
+    appendNumber(_reply, played);
+    _reply += ' ';
+    appendNumber(_reply, _core->stateHash(), 16);
+    _reply += _core->isGameOver() ? " 1" : " 0";
+}
+
+const std::string& LineDriver::execute(std::string_view command) {
+    if(!command.empty() && command.back() == '\r') { command.remove_suffix(1); }
+
+    if(command == "hash") {
+        _reply.clear();
+        appendNumber(_reply, _core->stateHash(), 16);
+    }
+    else if(command == "reset") {
+        _core->restore(_start);
+        playInputs({});
+    }
+    else if(command == "dump") {
+        const Map& map{_core->getMap()};
+        _reply.clear();
+        appendNumber(_reply, map.size.first); _reply += ' ';
+        appendNumber(_reply, map.size.second); _reply += ' ';
+        appendNumber(_reply, map.entities.size());
+        for(const MapEntity& entity : map.entities) {
+            _reply += ' ';
+            _reply += entityTypeToString.at(entity.getType());
+            _reply += ' ';
+            appendNumber(_reply, entity.getPosition().first); _reply += ' ';
+            appendNumber(_reply, entity.getPosition().second);
+        }
+    }
+    else if(command.find_first_not_of("UDLRXZYSQ.") == std::string_view::npos)
+        playInputs(command);
+    else
+        _reply = "ERR unknown command";
+    return _reply;
+}
+
+void LineDriver::run(std::istream& in, std::ostream& out) {
+    std::string line;
+    while(std::getline(in, line) && line != "quit" && line != "quit\r") {
+        out << execute(line) << '\n';
+        if(in.rdbuf()->in_avail() <= 0) { out.flush(); }
+    }
+    out.flush();
+}
@@ -0,0 +1,145 @@
+#include "../SessionHost.h"
+#include "../../core/Core.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+
+namespace {
+// The size of the replies waiting to be sent above which a session is no longer read from
+constexpr std::size_t MAX_OUTPUT{1 << 20};
+
+bool isPlayable(unsigned char input) {
+    return input <= static_cast<unsigned char>(UserInput::REDO);
+}
+}
+
+SessionHost::SessionHost(const std::string& path, const std::vector<std::string>& levels, std::size_t threads)
+    : _path{path}, _levels{levels}, _listener{::socket(AF_UNIX, SOCK_STREAM, 0)}, _pool{threads} {
+    if(levels.empty()) { ::close(_listener); throw std::invalid_argument("No level"); }
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if(_listener < 0 || path.size() >= sizeof(address.sun_path)) { throw std::runtime_error("Can't create a socket for "+path); }
+    std::strcpy(address.sun_path, path.c_str());
+    ::unlink(path.c_str());
+    if(::bind(_listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(_listener, SOMAXCONN) != 0) {
+        ::close(_listener);
+        throw std::runtime_error("Can't listen on "+path);
+    }
+    ::fcntl(_listener, F_SETFL, O_NONBLOCK);
+}
+
+SessionHost::~SessionHost() {
+    for(const auto& session : _sessions) { ::close(session->socket); }
+    ::close(_listener);
+    ::unlink(_path.c_str());
+}
+
+void SessionHost::accept() {
+    for(int socket; (socket = ::accept(_listener, nullptr, nullptr)) >= 0;) {
+        ::fcntl(socket, F_SETFL, O_NONBLOCK);
+        auto session{std::make_unique<Session>(Session{socket})};
+        try { session->core = std::make_unique<Core>(_levels[_nextLevel++ % _levels.size()]); }
+        catch(const std::exception&) { ::close(socket); continue; }
+        session->core->update();
+        session->start = session->core->snapshot();
+        _sessions.push_back(std::move(session));
+    }
+}
+
+void SessionHost::receive(Session& session) {
+    char buffer[4096];
+    while(true) {
+        const ssize_t read{::recv(session.socket, buffer, sizeof(buffer), 0)};
+        if(read > 0) { session.input.append(buffer, read); continue; }
+        if(read == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) { session.closed = true; }
+        return;
+    }
+}
+
+void SessionHost::reply(Session& session, HostProtocol::Reply reply) {
+    reply.gameOver = session.core->isGameOver();
+    reply.entities = session.core->getMap().entities.size();
+    reply.hash = session.core->stateHash();
+    session.output.append(reinterpret_cast<const char*>(&reply), sizeof(reply));
+}
+
+void SessionHost::process(Session& session) {
+    using namespace HostProtocol;
+    std::size_t offset{};
+    RequestHeader header;
+    while(session.input.size() - offset >= sizeof(header) && session.output.size() < MAX_OUTPUT) {
+        std::memcpy(&header, session.input.data() + offset, sizeof(header));
+        if(session.input.size() - offset - sizeof(header) < header.length) { break; }
+        const char* payload{session.input.data() + offset + sizeof(header)};
+        offset += sizeof(header) + header.length;
+
+        switch(header.opcode) {
+            case INPUTS: {
+                const auto inputs{reinterpret_cast<const unsigned char*>(payload)};
+                if(!std::all_of(inputs, inputs + header.length, isPlayable)) { reply(session, {}); break; }
+                std::uint16_t played{};
+                for(std::size_t i{}; i<header.length && !session.core->isGameOver(); ++i, ++played) {
+                    session.core->manageInput(static_cast<UserInput>(inputs[i]));
+                    session.core->update();
+                }
+                _moves += played;
+                reply(session, {INPUTS, 0, played});
+                break;
+            }
+            case HASH: reply(session, {HASH}); break;
+            case RESTART:
+                session.core->restore(session.start);
+                reply(session, {RESTART});
+                break;
+            default: reply(session, {}); break;
+        }
+    }
+    session.input.erase(0, offset);
+}
+
+void SessionHost::send(Session& session) {
+    std::size_t sent{};
+    while(sent < session.output.size()) {
+        const ssize_t written{::send(session.socket, session.output.data() + sent, session.output.size() - sent, MSG_NOSIGNAL)};
+        if(written > 0) { sent += written; continue; }
+        if(errno != EAGAIN && errno != EWOULDBLOCK) { session.closed = true; }
+        break;
+    }
+    session.output.erase(0, sent);
+}
+
+void SessionHost::run() {
+    std::vector<pollfd> sockets;
+    while(!_stopping) {
+        sockets.clear();
+        sockets.push_back({_listener, POLLIN, 0});
+        for(const auto& session : _sessions) {
+            const bool backlogged{session->output.size() >= MAX_OUTPUT};
+            sockets.push_back({session->socket, static_cast<short>((backlogged ? 0 : POLLIN) | (session->output.empty() ? 0 : POLLOUT)), 0});
+        }
+        // Wakes up regularly to notice stop()
+        if(::poll(sockets.data(), sockets.size(), 100) <= 0) { continue; }
+
+        _ready.clear();
+        for(std::size_t i{}; i<_sessions.size(); ++i) {
+            Session& session{*_sessions[i]};
+            if(session.output.size() >= MAX_OUTPUT) { continue; }
+            if(sockets[i+1].revents & (POLLIN | POLLHUP | POLLERR)) { receive(session); }
+            if(!session.closed && session.input.size() >= sizeof(HostProtocol::RequestHeader)) { _ready.push_back(&session); }
+        }
+        if(sockets[0].revents & POLLIN) { accept(); }
+
+        _pool.parallelFor(_ready.size(), [this](std::size_t begin, std::size_t end) {
+            for(std::size_t i{begin}; i<end; ++i) { process(*_ready[i]); }
+        });
+
+        for(const auto& session : _sessions)
+            if(!session->output.empty() && !session->closed) { send(*session); }
+        std::erase_if(_sessions, [](const std::unique_ptr<Session>& session) {
+            if(session->closed) { ::close(session->socket); }
+            return session->closed;
+        });
+        _sessionCount = _sessions.size();
+    }
+}
@@ -0,0 +1,88 @@
+/**
+    @file AsyncSaver.h
+    @brief Defines the AsyncSaver class, which writes saves on a background thread.
+*/
+
+#ifndef ASYNCSAVER_H
+#define ASYNCSAVER_H
+
+#include "MapSnapshot.h"
+#include "RuleCache.h"
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+    @brief Writes saves on a background thread, so the game loop never waits for the disk.
+    @details A save request only holds immutable snapshots, which share their storage with the game.
+    The writer thread turns each request into a text level and a binary state, both written
+    to temporary files renamed once complete. It is only started by the first save, since most
+    games never save. A save which fails doesn't stop the game, it is counted instead.
+*/
+class AsyncSaver {
+public:
+    /**
+        @brief Everything needed to write a save, captured when the save was requested.
+    */
+    struct Request {
+        MapSnapshot map;
+        MapSnapshot initialMap;
+        EntityType playerEntity;
+        bool gameOver;
+        std::vector<Sentence> rules;
+        std::string directory{"saves"};
+        std::time_t time{std::time(nullptr)};
+    };
+
+private:
+    mutable std::mutex _mutex;
+    std::condition_variable _requested;
+    std::condition_variable _written;
+    std::deque<Request> _requests;
+    bool _writing{};
+    bool _stopping{};
+    std::size_t _failures{};
+    std::string _lastError;
+    std::thread _writer;
+
+    void run();
+    static void write(const Request& request);
+public:
+    AsyncSaver() = default;
+    /**
+        @brief Writes the pending saves, then stops the writer thread if it was started.
+    */
+    ~AsyncSaver();
+
+    AsyncSaver(const AsyncSaver&) = delete;
+    AsyncSaver& operator=(const AsyncSaver&) = delete;
+
+    /**
+        @brief Queues a save and returns immediately, starting the writer thread if needed.
+        @param request The snapshots to write.
+    */
+    void save(Request request);
+
+    /**
+        @brief Blocks until every queued save is written.
+    */
+    void flush();
+
+    /**
+        @brief Gets the number of saves which could not be written, the game going on without them.
+        @return The number of failed saves.
+    */
+    std::size_t failures() const;
+
+    /**
+        @brief Gets why the last failed save could not be written.
+        @return The message of the error, empty if no save failed.
+    */
+    std::string lastError() const;
+};
+
+#endif // ASYNCSAVER_H
@@ -0,0 +1,107 @@
+/**
+    @file BatchEnvironment.h
+    @brief Defines the BatchEnvironment class, a vectorized reset/step environment for reinforcement learning.
+*/
+
+#ifndef BATCHENVIRONMENT_H
+#define BATCHENVIRONMENT_H
+
+#include "Simulation.h"
+#include "../utils/ThreadPool.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+    @brief Plays many games in parallel, each on one of a set of levels, through a reset/step interface.
+    @details Observations are written in place into a caller-provided tensor of shape
+    [environment][EntityType][row][col], where a cell is 1 if an entity of that type stands on it and
+    0 otherwise; every level is padded to the largest one. A game ends when it is won (+1 reward),
+    when no entity is controlled anymore (-1 reward), on QUIT, or after the maximum number of steps.
+    An ended game is reset at once, and the observation written for it is its first one.
+    Stepping runs the games on a thread pool, and allocates nothing once every game has reached the
+    capacity of its largest state.
+*/
+class BatchEnvironment {
+public:
+    /**
+        @brief The number of observation planes, one per EntityType.
+    */
+    static constexpr std::size_t PLANES{RuleTable::TYPE_COUNT};
+
+private:
+    std::vector<Simulation::State> _levels;
+    std::vector<Simulation::State> _starts; // _levels after their first update
+    std::vector<Simulation::State> _states;
+    std::vector<std::uint32_t> _steps;
+    std::size_t _maxSteps;
+    std::int16_t _rows{};
+    std::int16_t _cols{};
+    ThreadPool _pool;
+
+    void check(std::span<std::uint8_t> observations) const;
+    void reset(std::size_t env, std::uint8_t* observation);
+    void observe(std::size_t env, std::uint8_t* observation) const;
+public:
+    /**
+        @brief Creates the environments, environment i playing level i modulo the number of levels.
+        @param levels The initial states of the levels, as built by Simulation::fromMap.
+        @param envs The number of environments.
+        @param maxSteps The number of steps after which a game is cut short, 0 for no limit.
+        @param threads The number of threads stepping the games, 0 to use every core.
+        @throws std::invalid_argument If there is no level or no environment, or if an entity lies outside its level.
+    */
+    BatchEnvironment(const std::vector<Simulation::State>& levels, std::size_t envs, std::size_t maxSteps = 0, std::size_t threads = 0);
+
+    /**
+        @brief Restarts every game.
+        @param observations The [size()][PLANES][rows()][cols()] tensor to write the first observations in.
+        @throws std::invalid_argument If the tensor doesn't have observationSize() elements.
+    */
+    void reset(std::span<std::uint8_t> observations);
+
+    /**
+        @brief Advances every game by one action.
+        @param actions One action per environment.
+        @param observations The [size()][PLANES][rows()][cols()] tensor to write the new observations in.
+        @param rewards The reward of each environment.
+        @param dones Set to 1 for each environment whose game ended, and was reset, 0 otherwise.
+        @throws std::invalid_argument If an array doesn't have one element per environment, or the tensor observationSize() elements.
+    */
+    void step(std::span<const UserInput> actions, std::span<std::uint8_t> observations, std::span<float> rewards, std::span<std::uint8_t> dones);
+
+    /**
+        @brief Gets the number of environments.
+        @return The number of environments.
+    */
+    std::size_t size() const { return _states.size(); }
+
+    /**
+        @brief Gets the number of rows of an observation plane.
+        @return The largest number of rows among the levels.
+    */
+    std::size_t rows() const { return _rows; }
+
+    /**
+        @brief Gets the number of columns of an observation plane.
+        @return The largest number of columns among the levels.
+    */
+    std::size_t cols() const { return _cols; }
+
+    /**
+        @brief Gets the number of elements of the observation tensor.
+        @return size() * PLANES * rows() * cols().
+    */
+    std::size_t observationSize() const { return size()*PLANES*rows()*cols(); }
+
+    /**
+        @brief Gets the current state of an environment.
+        @param env The index of the environment.
+        @return The state of its game.
+        @throws std::out_of_range If there is no such environment.
+    */
+    const Simulation::State& state(std::size_t env) const { return _states.at(env); }
+};
+
+#endif // BATCHENVIRONMENT_H
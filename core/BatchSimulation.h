@@ -0,0 +1,135 @@
+/**
+    @file BatchSimulation.h
+    @brief Defines the BatchSimulation class, which advances many games of the same level in lockstep.
+*/
+
+#ifndef BATCHSIMULATION_H
+#define BATCHSIMULATION_H
+
+#include "Simulation.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+    @brief Throughput of a batch simulation.
+*/
+struct BatchStats {
+    std::uint64_t gameSteps{};
+    double seconds{};
+
+    /**
+        @brief Computes the number of game steps simulated per second.
+        @return The throughput, 0 if nothing was simulated yet.
+    */
+    double stepsPerSecond() const { return seconds > 0 ? gameSteps / seconds : 0; }
+};
+
+/**
+    @brief Advances N games of the same level at once, one input per game and per step.
+    @details The games are stored as a structure of arrays, in blocks of LANES games indexed by
+    [block][entity slot][lane], so every rule is applied by loops whose innermost dimension is the
+    game, which the compiler vectorizes, while the working set of a block stays in cache.
+    Each game follows Simulation::step exactly: a removed entity is only marked dead, so the slots
+    stay aligned across games, and the rules of each game are stored in per-game slots applied
+    under a mask, since two games may have built different sentences. The texts, the permanent
+    rules and the effect of each sentence all come from RuleTable, like in Core and Simulation::step.
+*/
+class BatchSimulation {
+public:
+    /**
+        @brief The number of games advanced by one vectorized loop.
+    */
+    static constexpr std::size_t LANES{64};
+
+private:
+    std::size_t _games;
+    std::size_t _blocks;
+    std::size_t _entities;
+    std::int16_t _rows;
+    std::int16_t _cols;
+    std::size_t _block{};
+
+    // [block][entity slot][lane]
+    std::vector<std::int16_t> _row, _col, _dRow, _dCol;
+    std::vector<std::uint8_t> _type, _alive;
+    // [entity slot], the map restored by RESET
+    std::vector<std::int16_t> _initialRow, _initialCol;
+    std::vector<std::uint8_t> _initialType, _initialAlive;
+    // [block][rule slot][lane]
+    std::vector<std::uint8_t> _ruleSubject, _ruleProperty;
+    // [block][lane]
+    std::vector<std::uint16_t> _ruleCount;
+    std::vector<std::uint8_t> _player, _gameOver, _reset;
+    std::vector<std::int16_t> _inputRow, _inputCol;
+    // [entity slot][lane], [entity slot] and [lane], scratch space of the current block
+    std::vector<std::uint8_t> _mark;
+    std::vector<std::uint8_t> _moving; // Whether an entity moves in any game, only moving entities push or get stopped
+    std::vector<std::size_t> _words; // The entity slots holding a text in any game
+    std::vector<std::uint8_t> _looping, _changed, _isText, _mask, _selected, _subject, _property, _effect;
+    std::vector<std::int16_t> _foundRow, _foundCol;
+    std::vector<std::int32_t> _found;
+    BatchStats _stats;
+
+    std::size_t at(std::size_t slot) const { return (_block*_entities + slot)*LANES; }
+    std::size_t lanes() const { return _block*LANES; }
+    std::size_t rule(std::size_t k) const { return (_block*2*_entities + k)*LANES; }
+    static bool any(const std::vector<std::uint8_t>& lanes);
+    bool selectSubjects(std::size_t slot);
+
+    void move();
+    void applyPermanentRules();
+    void updateRules();
+    void applyRules();
+
+    void push();
+    void stop();
+    void win();
+    void kill();
+    void sink();
+    void you();
+    void transform();
+public:
+    /**
+        @brief Creates N copies of a game.
+        @param start The state every game starts from; RESET restores the state its State::initial points to, or start itself.
+        @param games The number of games.
+    */
+    BatchSimulation(const Simulation::State& start, std::size_t games);
+
+    /**
+        @brief Advances every game by one input, as Simulation::step would.
+        @param inputs One input per game.
+        @throws std::invalid_argument If there isn't exactly one input per game.
+    */
+    void step(const std::vector<UserInput>& inputs);
+
+    /**
+        @brief Gets the number of games.
+        @return The number of games.
+    */
+    std::size_t size() const { return _games; }
+
+    /**
+        @brief Extracts the state of one game.
+        @param game The index of the game.
+        @return The state of the game, without its State::initial pointer.
+        @throws std::out_of_range If there is no such game.
+    */
+    Simulation::State state(std::size_t game) const;
+
+    /**
+        @brief Tells whether a game is over.
+        @param game The index of the game.
+        @return true if the game is over, false otherwise.
+    */
+    bool isGameOver(std::size_t game) const { return _gameOver.at(game); }
+
+    /**
+        @brief Gets the throughput since the creation of the batch.
+        @return The number of game steps simulated and the time spent simulating them.
+    */
+    const BatchStats& getStats() const { return _stats; }
+};
+
+#endif // BATCHSIMULATION_H
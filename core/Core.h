@@ -11,35 +11,93 @@
 #include <memory>
 #include "MapEntity.h"
 #include "Rules.h"
+#include "RuleCache.h"
 #include "Map.h"
+#include "DeltaJournal.h"
+#include "MapSnapshot.h"
+#include "SessionJournal.h"
+#include "CoreState.h"
+#include "AsyncSaver.h"
+#include "Zobrist.h"
 #include "../utils/subject.h"
 
 /**
     @brief The Core class manages the game logic and state.
 */
-class Core : public nvs::Subject {
+class Core : public nvs::Subject, private EntityListener {
     Map _map;
-    Map _initialMap;
+    MapSnapshot _initialMap;
     const std::map<std::pair<EntityType, EntityType>, std::shared_ptr<Rule>> _allRules;
     const std::vector<std::shared_ptr<Rule>> _permanentRules;
-    std::vector<std::shared_ptr<Rule>> _rules;
+    std::shared_ptr<const CompiledRules> _rules;
+    RuleCache _ruleCache;
     EntityType _playerEntity;
     bool _gameOver;
+    DeltaJournal _journal;
+    MapDelta _tick;
+    TickStep _lastStep;
+    bool _recording;
+    bool _settling{};
+    mutable MapSnapshot _snapshot;
+    mutable MapSnapshot::DirtyChunks _dirtyChunks;
+    std::uint64_t _entitiesHash;
+    std::unique_ptr<SessionJournal> _session;
+    AsyncSaver _saver;
+    std::string _saveDirectory{"saves"};
+    bool _notificationsSuspended{};
 
+    static CoreState loadState(const std::string& filePath);
     std::map<std::pair<EntityType, EntityType>, std::shared_ptr<Rule>> getAllRules();
+    static std::vector<std::shared_ptr<Rule>> getPermanentRules();
     void movePlayer(Direction direction);
     void resetMap();
     void resetEntities();
     void updateRules();
+    void refreshRules();
+    CompiledRules compileRules(const std::vector<Sentence>& sentences) const;
     void applyPermanentRules();
     void applyRules();
+    void attachEntities();
+    void replacedEntities();
+    void beginTick();
+    void commitTick();
+    void journalInput(UserInput input);
+    void undo();
+    void redo();
+    void entityMoved(const MapEntity& entity, Position from) override;
+    void entityTypeChanged(const MapEntity& entity, EntityType oldType) override;
+    void entityRemoved(const MapEntity& entity) override;
+    void entityAdded(const MapEntity& entity) override;
 public:
     /**
         @brief Constructs a new Core object with the game map loaded from the specified file.
-        @param filePath The path of the file containing the game map.
+        @param filePath The path of the file containing the game map, either a level or a binary snapshot.
     */
     Core(const std::string& filePath);
 
+    /**
+        @brief Constructs a new Core object resuming a saved game.
+        @param state The state of the saved game.
+    */
+    explicit Core(const CoreState& state);
+
+    /**
+        @brief Constructs a new Core object whose inputs are journalled to survive a crash.
+        @details If the journal directory holds an interrupted session of the same level, the game
+        resumes from its last snapshot and the inputs journalled after it. If the journal directory
+        can't be created, or a write of the journal fails later, the game goes on without journal.
+        @param filePath The path of the file containing the game map.
+        @param journalDirectory The directory holding the session journal.
+        @param snapshotInterval The number of inputs between two snapshots of the map.
+    */
+    Core(const std::string& filePath, const std::string& journalDirectory, unsigned snapshotInterval = 64);
+
+    /**
+        @brief Copying a Core would leave its rules and entities pointing to the original.
+    */
+    Core(const Core&) = delete;
+    Core& operator=(const Core&) = delete;
+
     /**
         @brief Gets the current game map.
         @return The current game map.
@@ -51,6 +109,90 @@ public:
         @return true if the game is over, false otherwise.
     */
     bool isGameOver() const;
+
+    /**
+        @brief Gets the rules compiled from the sentences active during the last update.
+        @return The compiled rules.
+    */
+    const CompiledRules& getActiveRules() const;
+
+    /**
+        @brief Gets the hit and miss counters of the compiled rules cache.
+        @return The cache counters.
+    */
+    const RuleCacheStats& getRuleCacheStats() const;
+
+    /**
+        @brief Gets the journal of the ticks that can be undone and redone.
+        @return The journal.
+    */
+    const DeltaJournal& getJournal() const;
+
+    /**
+        @brief Gets how the map changed during the last tick.
+        @return The last tick, without delta if the last input changed nothing.
+    */
+    const TickStep& getLastStep() const;
+
+    /**
+        @brief Gets the Zobrist hash of the current state (entities on their cells and player entity).
+        @details The hash is kept up to date by every change made to the map, so this call is O(1).
+        @return The 64-bit hash of the state.
+    */
+    std::uint64_t stateHash() const;
+
+    /**
+        @brief Takes an immutable snapshot of the current map.
+        @details The snapshot shares its storage with the previous snapshots, only the chunks
+        modified since the last call are copied.
+        @return The snapshot.
+    */
+    MapSnapshot snapshot() const;
+
+    /**
+        @brief Replaces the current map by a snapshot and updates the game state accordingly.
+        @details The entities are copied out of the snapshot, so this is linear in their number.
+        The undo history is discarded since it does not apply to the restored map. Observers are
+        not notified, so that a tool can branch through many snapshots; refreshObservers() does.
+        @param snapshot The snapshot to restore, taken from a Core playing the same level.
+    */
+    void restore(const MapSnapshot& snapshot);
+
+    /**
+        @brief Gets everything needed to resume the game later.
+        @return The state of the game.
+        @throws std::out_of_range If the map is too large to be saved.
+    */
+    CoreState getState() const;
+
+    /**
+        @brief Blocks until every save requested so far, and the session journal, is written to disk.
+    */
+    void flushSaves();
+
+    /**
+        @brief Checks whether the inputs are journalled.
+        @return false if the game was started without a journal, ended, or the journal couldn't be written.
+    */
+    bool isJournaling() const;
+
+    /**
+        @brief Gets the number of saves which could not be written.
+        @return The number of failed saves.
+    */
+    std::size_t failedSaves() const;
+
+    /**
+        @brief Gets why the last failed save could not be written.
+        @return The message of the error, empty if no save failed.
+    */
+    std::string lastSaveError() const;
+
+    /**
+        @brief Sets the directory the saves are written to, "saves" by default.
+        @param directory The directory, created by the first save.
+    */
+    void setSaveDirectory(const std::string& directory);
     
     /**
         @brief Manages the user input.
@@ -62,6 +204,18 @@ public:
         @brief Updates the game state and notifies the view.
     */
     void update();
+
+    /**
+        @brief Suspends or resumes the notification of the observers at the end of each update.
+        @details While suspended, updates are bound by the simulation alone; refreshObservers() still notifies.
+        @param suspended true to suspend the notifications, false to resume them.
+    */
+    void setNotificationsSuspended(bool suspended);
+
+    /**
+        @brief Notifies the observers of the current state, even while notifications are suspended.
+    */
+    void refreshObservers() const;
 };
 
 #endif // CORE_H
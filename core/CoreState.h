@@ -0,0 +1,248 @@
+/**
+    @file CoreState.h
+    @brief Defines the full state of a Core, as well as a namespace with functions to save and load it in a binary format.
+*/
+
+#ifndef CORESTATE_H
+#define CORESTATE_H
+
+#include "Map.h"
+#include "MapEntity.h"
+#include "MapSnapshot.h"
+#include "RuleCache.h"
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+    @brief An entity of a saved map, stored as plain data.
+*/
+struct PackedEntity {
+    std::uint16_t row;
+    std::uint16_t col;
+    std::uint8_t type;
+    std::uint8_t reserved;
+};
+static_assert(std::is_trivially_copyable_v<PackedEntity> && sizeof(PackedEntity) == 6);
+
+/**
+    @brief Structure holding everything needed to resume a game.
+*/
+struct CoreState {
+    std::string levelName;
+    std::pair<unsigned, unsigned> size;
+    std::vector<PackedEntity> entities;
+    std::vector<PackedEntity> initialEntities;
+    EntityType playerEntity;
+    bool gameOver;
+    std::vector<Sentence> rules;
+
+    /**
+        @brief Packs an entity.
+        @param entity The entity to pack.
+        @return The packed entity.
+        @throws std::out_of_range If the position of the entity doesn't fit in 16 bits.
+    */
+    static PackedEntity pack(const MapEntity& entity) {
+        const auto [row, col] = entity.getPosition();
+        if(row > UINT16_MAX || col > UINT16_MAX)
+            throw std::out_of_range("Position too large to be saved: "+std::to_string(row)+" "+std::to_string(col));
+        return {static_cast<std::uint16_t>(row), static_cast<std::uint16_t>(col), static_cast<std::uint8_t>(entity.getType()), 0};
+    }
+
+    /**
+        @brief Packs the entities of a map.
+        @param entities The entities to pack.
+        @return The packed entities.
+        @throws std::out_of_range If the position of an entity doesn't fit in 16 bits.
+    */
+    static std::vector<PackedEntity> pack(const std::vector<MapEntity>& entities) {
+        std::vector<PackedEntity> result;
+        result.reserve(entities.size());
+        for(const MapEntity& entity : entities)
+            result.push_back(pack(entity));
+        return result;
+    }
+
+    /**
+        @brief Packs the entities of a map snapshot.
+        @param map The snapshot to pack.
+        @return The packed entities.
+        @throws std::out_of_range If the position of an entity doesn't fit in 16 bits.
+    */
+    static std::vector<PackedEntity> pack(const MapSnapshot& map) {
+        std::vector<PackedEntity> result;
+        result.reserve(map.entityCount());
+        for(std::size_t i{}; i<map.entityCount(); ++i)
+            result.push_back(pack(map.at(i)));
+        return result;
+    }
+
+    /**
+        @brief Unpacks entities into a map, replacing its content.
+        @param map The map to fill, whose size must already be set.
+        @param entities The packed entities.
+    */
+    static void unpack(Map& map, const std::vector<PackedEntity>& entities) {
+        map.entities.clear();
+        map.entities.reserve(entities.size());
+        for(const PackedEntity& entity : entities)
+            map.entities.emplace_back(static_cast<EntityType>(entity.type), entity.row, entity.col, &map.size);
+    }
+};
+
+/**
+    @brief Namespace containing functions to save and load a CoreState in a versioned binary format.
+    @details The file starts with the magic "BABS", a format version and the counts of every block,
+    followed by the level name, the current and initial entities as arrays of PackedEntity and
+    the active sentences. Numbers are stored in the byte order of the machine.
+*/
+namespace BinarySnapshot {
+/**
+    @brief The magic number starting every binary snapshot.
+*/
+constexpr char MAGIC[4]{'B', 'A', 'B', 'S'};
+
+/**
+    @brief The version of the format written by this build.
+*/
+constexpr std::uint16_t VERSION{1};
+
+/**
+    @brief Fixed-size header of a binary snapshot.
+*/
+struct Header {
+    char magic[4];
+    std::uint16_t version;
+    std::uint8_t playerEntity;
+    std::uint8_t gameOver;
+    std::uint32_t rows;
+    std::uint32_t cols;
+    std::uint32_t nameLength;
+    std::uint32_t entityCount;
+    std::uint32_t initialEntityCount;
+    std::uint32_t ruleCount;
+};
+static_assert(std::is_trivially_copyable_v<Header>);
+
+/**
+    @brief Writes a state to a stream.
+    @param outfile The binary stream to write to.
+    @param state The state to write.
+*/
+inline void write(std::ostream& outfile, const CoreState& state) {
+    Header header{{}, VERSION, static_cast<std::uint8_t>(state.playerEntity), state.gameOver, state.size.first, state.size.second,
+        static_cast<std::uint32_t>(state.levelName.size()), static_cast<std::uint32_t>(state.entities.size()),
+        static_cast<std::uint32_t>(state.initialEntities.size()), static_cast<std::uint32_t>(state.rules.size())};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+
+    std::vector<std::uint8_t> rules;
+    for(const auto& [subject, property] : state.rules) {
+        rules.push_back(static_cast<std::uint8_t>(subject));
+        rules.push_back(static_cast<std::uint8_t>(property));
+    }
+    outfile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outfile.write(state.levelName.data(), state.levelName.size());
+    outfile.write(reinterpret_cast<const char*>(state.entities.data()), state.entities.size()*sizeof(PackedEntity));
+    outfile.write(reinterpret_cast<const char*>(state.initialEntities.data()), state.initialEntities.size()*sizeof(PackedEntity));
+    outfile.write(reinterpret_cast<const char*>(rules.data()), rules.size());
+}
+
+/**
+    @brief Reads a state from a stream.
+    @details Every count is checked against the bytes left in the stream before anything is allocated,
+    and every entity, position and sentence against what a map can hold.
+    @param file The binary stream to read, which must be seekable.
+    @return The state.
+    @throws std::invalid_argument If the stream is not a binary snapshot, is truncated, has an unknown version or holds invalid data.
+*/
+inline CoreState read(std::istream& file) {
+    Header header;
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::invalid_argument("Not a binary snapshot");
+    if(header.version != VERSION)
+        throw std::invalid_argument("Unsupported snapshot version: "+std::to_string(header.version));
+    if(header.playerEntity > BEST)
+        throw std::invalid_argument("Invalid player entity: "+std::to_string(header.playerEntity));
+
+    const std::istream::pos_type position{file.tellg()};
+    file.seekg(0, std::ios::end);
+    const std::istream::pos_type end{file.tellg()};
+    file.seekg(position);
+    if(position < 0 || end < 0 || !file)
+        throw std::invalid_argument("Binary snapshots must be read from a seekable stream");
+    const std::uint64_t expected{header.nameLength + (std::uint64_t{header.entityCount} + header.initialEntityCount)*sizeof(PackedEntity) + std::uint64_t{header.ruleCount}*2};
+    if(expected > static_cast<std::uint64_t>(end - position))
+        throw std::invalid_argument("Truncated binary snapshot");
+
+    CoreState result{std::string(header.nameLength, '\0'), {header.rows, header.cols},
+        std::vector<PackedEntity>(header.entityCount), std::vector<PackedEntity>(header.initialEntityCount),
+        static_cast<EntityType>(header.playerEntity), header.gameOver != 0, {}};
+    std::vector<std::uint8_t> rules(header.ruleCount*std::size_t{2});
+    file.read(result.levelName.data(), result.levelName.size());
+    file.read(reinterpret_cast<char*>(result.entities.data()), result.entities.size()*sizeof(PackedEntity));
+    file.read(reinterpret_cast<char*>(result.initialEntities.data()), result.initialEntities.size()*sizeof(PackedEntity));
+    file.read(reinterpret_cast<char*>(rules.data()), rules.size());
+    if(!file)
+        throw std::invalid_argument("Truncated binary snapshot");
+    for(const auto* entities : {&result.entities, &result.initialEntities})
+        for(const PackedEntity& entity : *entities) {
+            if(entity.type > BEST || entity.type == NONE)
+                throw std::invalid_argument("Invalid entity type: "+std::to_string(entity.type));
+            if(entity.row >= header.rows || entity.col >= header.cols)
+                throw std::invalid_argument("Entity out of the map: "+std::to_string(entity.row)+" "+std::to_string(entity.col));
+        }
+    for(std::size_t i{}; i<rules.size(); i+=2) {
+        const Sentence sentence{static_cast<EntityType>(rules.at(i)), static_cast<EntityType>(rules.at(i+1))};
+        if(!RuleTable::isSentence(sentence))
+            throw std::invalid_argument("Invalid sentence: "+std::to_string(rules.at(i))+" "+std::to_string(rules.at(i+1)));
+        result.rules.push_back(sentence);
+    }
+    return result;
+}
+
+/**
+    @brief Checks whether a file is a binary snapshot.
+    @param filePath The path of the file.
+    @return true if the file starts with the snapshot magic number, false otherwise.
+*/
+inline bool isSnapshot(const std::string& filePath) {
+    char magic[sizeof(MAGIC)]{};
+    std::ifstream file{filePath, std::ios::binary};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+/**
+    @brief Saves a state to a file, through a temporary file renamed over the destination.
+    @param filePath The path of the file.
+    @param state The state to save.
+*/
+inline void save(const std::string& filePath, const CoreState& state) {
+    const std::string temporary{filePath+".tmp"};
+    {
+        std::ofstream outfile{temporary, std::ios::binary | std::ios::trunc};
+        write(outfile, state);
+    }
+    std::filesystem::rename(temporary, filePath);
+}
+
+/**
+    @brief Loads a state from a file.
+    @param filePath The path of the file.
+    @return The state.
+    @throws std::invalid_argument If the file doesn't exist or is not a valid binary snapshot.
+*/
+inline CoreState load(const std::string& filePath) {
+    std::ifstream file{filePath, std::ios::binary};
+    if(!file)
+        throw std::invalid_argument("File doesn't exist");
+    return read(file);
+}
+};
+
+#endif // CORESTATE_H
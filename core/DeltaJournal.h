@@ -0,0 +1,259 @@
+/**
+    @file DeltaJournal.h
+    @brief Defines the delta of a tick and the ring buffer journal used to undo and redo ticks.
+*/
+
+#ifndef DELTAJOURNAL_H
+#define DELTAJOURNAL_H
+
+#include "Map.h"
+#include "MapEntity.h"
+#include <memory>
+#include <vector>
+
+/**
+    @brief A single change made to an entity of the map during a tick.
+*/
+struct EntityChange {
+    /**
+        @brief The kind of change.
+    */
+    enum Kind { MOVE, TYPE, REMOVE };
+
+    Kind kind;
+    unsigned index;
+    EntityType type;
+    EntityType newType;
+    Position from;
+    Position to;
+};
+
+/**
+    @brief Structure holding every change made to a map during a tick.
+    @details Changes are stored in the order they happened, with the index each entity had at that time.
+    A tick that replaced the whole map (RESET) also keeps the entities before and after the replacement.
+*/
+struct MapDelta {
+    bool replaced{};
+    bool gameOverBefore{};
+    bool gameOverAfter{};
+    std::vector<MapEntity> entitiesBefore;
+    std::vector<MapEntity> entitiesAfter;
+    std::vector<EntityChange> changes;
+
+    /**
+        @brief Checks whether the tick changed anything.
+        @return true if the delta holds no change, false otherwise.
+    */
+    bool empty() const { return !replaced && changes.empty(); }
+
+    /**
+        @brief Records a move, merging it with the previous move of the same entity.
+        @param index The index of the entity in the map.
+        @param type The type of the entity.
+        @param from The previous position of the entity.
+        @param to The new position of the entity.
+    */
+    void recordMove(unsigned index, EntityType type, Position from, Position to) {
+        if(!changes.empty() && changes.back().kind == EntityChange::MOVE && changes.back().index == index && changes.back().to == from) {
+            changes.back().to = to;
+            if(changes.back().from == to) { changes.pop_back(); }
+            return;
+        }
+        changes.push_back({EntityChange::MOVE, index, type, type, from, to});
+    }
+
+    /**
+        @brief Records a type change.
+        @param index The index of the entity in the map.
+        @param oldType The previous type of the entity.
+        @param newType The new type of the entity.
+        @param position The position of the entity.
+    */
+    void recordType(unsigned index, EntityType oldType, EntityType newType, Position position) {
+        changes.push_back({EntityChange::TYPE, index, oldType, newType, position, position});
+    }
+
+    /**
+        @brief Records the removal of an entity.
+        @param index The index the entity had before being erased.
+        @param type The type of the entity.
+        @param position The position of the entity.
+    */
+    void recordRemoval(unsigned index, EntityType type, Position position) {
+        changes.push_back({EntityChange::REMOVE, index, type, type, position, position});
+    }
+
+    /**
+        @brief Reverts the changes of the tick on a map, newest change first.
+        @param map The map, in the state it had at the end of the tick.
+        @param listener The listener given to the entities put back on the map.
+    */
+    void undo(Map& map, EntityListener* listener) const {
+        for(auto change{std::rbegin(changes)}; change != std::rend(changes); ++change) {
+            switch(change->kind) {
+                case EntityChange::MOVE:
+                    map.entities.at(change->index).setPosition(change->from); break;
+                case EntityChange::TYPE:
+                    map.entities.at(change->index).setType(change->type); break;
+                case EntityChange::REMOVE: {
+                    MapEntity entity{change->type, change->from.first, change->from.second, &map.size};
+                    entity.setListener(listener);
+                    auto inserted{map.entities.insert(std::begin(map.entities)+change->index, entity)};
+                    if(listener) { listener->entityAdded(*inserted); }
+                    break;
+                }
+            }
+        }
+        if(replaced) { replaceEntities(map, entitiesBefore, listener); }
+    }
+
+    /**
+        @brief Replays the changes of the tick on a map, oldest change first.
+        @param map The map, in the state it had at the beginning of the tick.
+        @param listener The listener given to the entities put on the map.
+    */
+    void redo(Map& map, EntityListener* listener) const {
+        if(replaced) { replaceEntities(map, entitiesAfter, listener); }
+        for(const auto& change : changes) {
+            switch(change.kind) {
+                case EntityChange::MOVE:
+                    map.entities.at(change.index).setPosition(change.to); break;
+                case EntityChange::TYPE:
+                    map.entities.at(change.index).setType(change.newType); break;
+                case EntityChange::REMOVE:
+                    map.entities.at(change.index).notifyRemoval();
+                    map.entities.erase(std::begin(map.entities)+change.index);
+                    break;
+            }
+        }
+    }
+
+private:
+    static void replaceEntities(Map& map, const std::vector<MapEntity>& entities, EntityListener* listener) {
+        map.entities = entities;
+        for(MapEntity& entity : map.entities) {
+            entity = MapEntity{entity.getType(), entity.getPosition().first, entity.getPosition().second, &map.size};
+            entity.setListener(listener);
+        }
+    }
+};
+
+/**
+    @brief Structure describing how the map changed during one call to Core::update.
+    @details A tick either replays a delta forwards (regular moves, redo) or backwards (undo).
+    A tick that changed nothing has no delta. After an undo or a redo, the changes the rules made
+    once the delta was applied are kept apart, and replayed forwards.
+*/
+struct TickStep {
+    std::shared_ptr<const MapDelta> delta;
+    bool backward{};
+    std::shared_ptr<const MapDelta> settled{};
+
+    /**
+        @brief Applies the tick to a map.
+        @param map The map, in the state it had before the tick.
+        @param listener The listener given to the entities put on the map.
+    */
+    void apply(Map& map, EntityListener* listener = nullptr) const {
+        if(!delta) { return; }
+        if(backward) { delta->undo(map, listener); }
+        else { delta->redo(map, listener); }
+        if(settled) { settled->redo(map, listener); }
+    }
+};
+
+/**
+    @brief A bounded ring buffer of MapDelta objects with an undo/redo cursor.
+    @details Once full, recording a new tick overwrites the oldest one.
+*/
+class DeltaJournal {
+    std::vector<std::shared_ptr<const MapDelta>> _entries;
+    std::size_t _capacity;
+    std::size_t _first;
+    std::size_t _undoable;
+    std::size_t _redoable;
+
+    std::size_t slot(std::size_t offset) const { return (_first+offset) % _capacity; }
+public:
+    /**
+        @brief Constructs an empty journal.
+        @param capacity The maximum number of ticks that can be undone.
+    */
+    DeltaJournal(std::size_t capacity = 1 << 16) : _capacity{capacity ? capacity : 1}, _first{}, _undoable{}, _redoable{} {}
+
+    /**
+        @brief Records a new tick, discarding the ticks that could be redone.
+        @param delta The changes of the tick.
+    */
+    void push(std::shared_ptr<const MapDelta> delta) {
+        _redoable = 0;
+        if(_undoable == _capacity) {
+            _first = slot(1);
+            --_undoable;
+        }
+        if(_entries.size() < _capacity && slot(_undoable) == _entries.size())
+            _entries.push_back(std::move(delta));
+        else
+            _entries.at(slot(_undoable)) = std::move(delta);
+        ++_undoable;
+    }
+
+    /**
+        @brief Moves the cursor one tick back.
+        @return The delta to undo, or nullptr if there is nothing to undo.
+    */
+    std::shared_ptr<const MapDelta> undo() {
+        if(_undoable == 0) { return nullptr; }
+        --_undoable; ++_redoable;
+        return _entries.at(slot(_undoable));
+    }
+
+    /**
+        @brief Moves the cursor one tick forward.
+        @return The delta to redo, or nullptr if there is nothing to redo.
+    */
+    std::shared_ptr<const MapDelta> redo() {
+        if(_redoable == 0) { return nullptr; }
+        --_redoable;
+        return _entries.at(slot(_undoable++));
+    }
+
+    /**
+        @brief Appends changes to the last tick that can be undone, discarding the ticks that could be redone.
+        @details The rules may change the map again right after an undo or a redo. These changes belong to
+        the tick that led to the current map, so that undoing it reverts them as well.
+        @param changes The changes made since the cursor last moved.
+    */
+    void amend(const MapDelta& changes) {
+        _redoable = 0;
+        if(_undoable == 0) { return; }
+        std::shared_ptr<const MapDelta>& entry{_entries.at(slot(_undoable-1))};
+        auto amended{std::make_shared<MapDelta>(*entry)};
+        amended->changes.insert(std::end(amended->changes), std::begin(changes.changes), std::end(changes.changes));
+        amended->gameOverAfter = changes.gameOverAfter;
+        entry = std::move(amended);
+    }
+
+    /**
+        @brief Forgets every recorded tick.
+    */
+    void clear() {
+        _entries.clear();
+        _first = _undoable = _redoable = 0;
+    }
+
+    /**
+        @brief Gets the number of ticks that can be undone.
+        @return The number of ticks.
+    */
+    std::size_t undoableCount() const { return _undoable; }
+
+    /**
+        @brief Gets the number of ticks that can be redone.
+        @return The number of ticks.
+    */
+    std::size_t redoableCount() const { return _redoable; }
+};
+
+#endif // DELTAJOURNAL_H
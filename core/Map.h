@@ -27,18 +27,14 @@ struct Map {
 */
 namespace LevelLoader {
 /**
-    @brief Loads a map from a file.
-    @param filePath The path to the file to load.
+    @brief Reads a map from a stream in the level format.
+    @param file The stream to read.
+    @param levelName The name given to the map.
     @return The loaded map.
-    @throws std::invalid_argument If the file contains an unknown entity name or an invalid position.
+    @throws std::invalid_argument If the stream contains an unknown entity name or an invalid position.
 */
-static Map loadLevel(const std::string& filePath) {
-    if(!std::filesystem::exists(filePath))
-        throw std::invalid_argument("File doesn't exist");
-
-    Map result{filePath};
-    std::ifstream file;
-    file.open(filePath);
+inline Map parseLevel(std::istream& file, const std::string& levelName) {
+    Map result{levelName, {}, {}};
     std::string lineBuffer;
     std::string entityName, x, y;
     std::getline(file, lineBuffer);
@@ -61,21 +57,68 @@ static Map loadLevel(const std::string& filePath) {
 }
 
 /**
-    @brief Saves a map to a file.
-    @param map A Map object to parse and save.
+    @brief Loads a map from a file.
+    @param filePath The path to the file to load.
+    @return The loaded map.
+    @throws std::invalid_argument If the file contains an unknown entity name or an invalid position.
 */
-static void saveLevel(const Map& map) {
-    const std::time_t t_c = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    if (!std::filesystem::is_directory("saves") || !std::filesystem::exists("saves"))
-        std::filesystem::create_directory("saves");
+inline Map loadLevel(const std::string& filePath) {
+    if(!std::filesystem::exists(filePath))
+        throw std::invalid_argument("File doesn't exist");
+
+    std::ifstream file{filePath};
+    return parseLevel(file, filePath);
+}
 
-    std::ofstream outfile{"saves/save_"+std::string(std::ctime(&t_c))+".txt"};
-    outfile << map.size.first << ' ' << map.size.second << '\n';
+/**
+    @brief Loads the inputs of a script, written one character per input (see charToInput, '.' being NONE).
+    @param filePath The path to the script.
+    @return The inputs, whitespace and unknown characters being skipped.
+    @throws std::invalid_argument If the file doesn't exist.
+*/
+inline std::vector<UserInput> loadScript(const std::string& filePath) {
+    if(!std::filesystem::exists(filePath))
+        throw std::invalid_argument("File doesn't exist");
+
+    std::ifstream file{filePath};
+    std::vector<UserInput> result;
+    for(char c; file.get(c);)
+        if(c == '.' || charToInput(c) != UserInput::NONE)
+            result.push_back(charToInput(c));
+    return result;
+}
+
+/**
+    @brief Writes a map to a stream in the level format.
+    @param outfile The stream to write to.
+    @param map A Map object to parse and write.
+*/
+inline void writeLevel(std::ostream& outfile, const Map& map) {
+    outfile << map.size.second << ' ' << map.size.first << '\n';
     for(const auto& entity : map.entities) {
         auto position{entity.getPosition()};
         outfile << entityTypeToString.at(entity.getType()) << ' ' << position.second << ' ' << position.first << '\n';
     }
+}
+
+/**
+    @brief Saves a map to a new file of a saves directory.
+    @details The map is written to a temporary file renamed once complete, so a save is never left half-written.
+    @param map A Map object to parse and save.
+    @param t_c The time the save was requested at, used to name the file.
+    @param directory The directory of the saves, created if needed.
+    @return The path of the written file.
+*/
+inline std::string saveLevel(const Map& map, std::time_t t_c = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()), const std::string& directory = "saves") {
+    if (!std::filesystem::is_directory(directory) || !std::filesystem::exists(directory))
+        std::filesystem::create_directories(directory);
+
+    const std::string filePath{directory+"/save_"+std::string(std::ctime(&t_c))+".txt"};
+    std::ofstream outfile{filePath+".tmp"};
+    writeLevel(outfile, map);
     outfile.close();
+    std::filesystem::rename(filePath+".tmp", filePath);
+    return filePath;
 }
 };
 
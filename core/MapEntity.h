@@ -22,6 +22,39 @@ enum EntityType{
     BEST
 };
 
+class MapEntity;
+
+/**
+    @brief Interface notified of every change made to a MapEntity.
+    @details Used to track what a tick changed without comparing whole maps.
+*/
+class EntityListener {
+public:
+    virtual ~EntityListener() = default;
+    /**
+        @brief Called after an entity changed position.
+        @param entity The entity, already at its new position.
+        @param from The previous position of the entity.
+    */
+    virtual void entityMoved(const MapEntity& entity, Position from) = 0;
+    /**
+        @brief Called after an entity changed type.
+        @param entity The entity, already of its new type.
+        @param oldType The previous type of the entity.
+    */
+    virtual void entityTypeChanged(const MapEntity& entity, EntityType oldType) = 0;
+    /**
+        @brief Called right before an entity is erased from the map.
+        @param entity The entity about to be erased.
+    */
+    virtual void entityRemoved(const MapEntity& entity) = 0;
+    /**
+        @brief Called right after an entity was inserted in the map.
+        @param entity The inserted entity.
+    */
+    virtual void entityAdded(const MapEntity& entity) = 0;
+};
+
 /**
     @brief Class representing a single entity on the game map.
 */
@@ -30,6 +63,7 @@ class MapEntity {
     Position _position;
     Direction _direction;
     std::pair<unsigned, unsigned>* _maxPos;
+    EntityListener* _listener{};
 public:
     /**
         @brief Constructs a new MapEntity object.
@@ -57,8 +91,20 @@ public:
         @param direction The direction to move in.
     */
     void move(Direction direction) {
+        Position from{_position};
         _direction = direction;
         _position = _position + direction;
+        if(_listener && direction != NODIR) _listener->entityMoved(*this, from);
+    }
+
+    /**
+        @brief Places the entity on a given position without giving it a direction.
+        @param position The new position.
+    */
+    void setPosition(Position position) {
+        Position from{_position};
+        _position = position;
+        if(_listener && !(from == position)) _listener->entityMoved(*this, from);
     }
 
     void resetDirection() {
@@ -86,7 +132,24 @@ public:
         @brief Sets the type of the entity.
         @param type The new type of the entity.
     */
-    void setType(EntityType type) { _type = type; }
+    void setType(EntityType type) {
+        EntityType oldType{_type};
+        _type = type;
+        if(_listener && oldType != type) _listener->entityTypeChanged(*this, oldType);
+    }
+
+    /**
+        @brief Notifies the listener that the entity is about to be erased from its map.
+    */
+    void notifyRemoval() const {
+        if(_listener) _listener->entityRemoved(*this);
+    }
+
+    /**
+        @brief Sets the object notified of the changes made to the entity.
+        @param listener The listener, or nullptr to stop notifications.
+    */
+    void setListener(EntityListener* listener) { _listener = listener; }
 };
 
 /**
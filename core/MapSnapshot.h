@@ -0,0 +1,196 @@
+/**
+    @file MapSnapshot.h
+    @brief Defines the MapSnapshot class, an immutable copy-on-write copy of a game map.
+*/
+
+#ifndef MAPSNAPSHOT_H
+#define MAPSNAPSHOT_H
+
+#include "Map.h"
+#include "MapEntity.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+    @brief An immutable map whose entities are stored in reference-counted chunks.
+    @details Copying a snapshot is O(1), and deriving a new snapshot from a modified map
+    only copies the chunks containing modified entities; the others are shared.
+*/
+class MapSnapshot {
+public:
+    /**
+        @brief The number of entities stored in a chunk.
+    */
+    static constexpr std::size_t CHUNK_SIZE{32};
+
+    /**
+        @brief Set of the chunks of a map that changed since the last snapshot.
+    */
+    class DirtyChunks {
+        std::vector<bool> _chunks;
+        std::size_t _shiftedFrom;
+        bool _all;
+    public:
+        DirtyChunks() : _shiftedFrom{static_cast<std::size_t>(-1)}, _all{true} {}
+
+        /**
+            @brief Marks the chunk holding an entity as modified.
+            @param index The index of the modified entity.
+        */
+        void markEntity(std::size_t index) {
+            std::size_t chunk{index / CHUNK_SIZE};
+            if(chunk >= _chunks.size()) { _chunks.resize(chunk+1); }
+            _chunks.at(chunk) = true;
+        }
+
+        /**
+            @brief Marks every chunk starting from an entity as modified, after an insertion or a removal.
+            @param index The index of the inserted or removed entity.
+        */
+        void markShift(std::size_t index) { _shiftedFrom = std::min(_shiftedFrom, index / CHUNK_SIZE); }
+
+        /**
+            @brief Marks the whole map as modified.
+        */
+        void markAll() { _all = true; }
+
+        /**
+            @brief Forgets every modification.
+        */
+        void clear() {
+            _chunks.assign(_chunks.size(), false);
+            _shiftedFrom = static_cast<std::size_t>(-1);
+            _all = false;
+        }
+
+        /**
+            @brief Checks whether a chunk must be rebuilt.
+            @param chunk The index of the chunk.
+            @return true if the chunk was modified, false otherwise.
+        */
+        bool isDirty(std::size_t chunk) const {
+            return _all || chunk >= _shiftedFrom || (chunk < _chunks.size() && _chunks.at(chunk));
+        }
+
+        /**
+            @brief Checks whether nothing was modified.
+            @return true if no chunk was marked, false otherwise.
+        */
+        bool empty() const {
+            return !_all && _shiftedFrom == static_cast<std::size_t>(-1) && std::find(std::begin(_chunks), std::end(_chunks), true) == std::end(_chunks);
+        }
+    };
+
+private:
+    using Chunk = std::vector<MapEntity>;
+
+    struct Root {
+        std::string levelName;
+        std::pair<unsigned, unsigned> size;
+        std::size_t entityCount;
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+    };
+
+    std::shared_ptr<const Root> _root;
+
+    static std::shared_ptr<const Chunk> makeChunk(const std::vector<MapEntity>& entities, std::size_t chunk) {
+        auto result{std::make_shared<Chunk>()};
+        std::size_t end{std::min(entities.size(), (chunk+1)*CHUNK_SIZE)};
+        result->reserve(end - chunk*CHUNK_SIZE);
+        for(std::size_t i{chunk*CHUNK_SIZE}; i<end; ++i)
+            result->emplace_back(entities.at(i).getType(), entities.at(i).getPosition().first, entities.at(i).getPosition().second, nullptr);
+        return result;
+    }
+
+public:
+    /**
+        @brief Constructs an empty snapshot.
+    */
+    MapSnapshot() : _root{std::make_shared<Root>()} {}
+
+    /**
+        @brief Constructs a snapshot by copying a whole map.
+        @param map The map to copy.
+    */
+    explicit MapSnapshot(const Map& map) : MapSnapshot{MapSnapshot{}.update(map, DirtyChunks{})} {}
+
+    /**
+        @brief Derives a snapshot of a modified map, sharing the unmodified chunks with this one.
+        @param map The modified map.
+        @param dirty The chunks of the map modified since this snapshot was taken.
+        @return The new snapshot.
+    */
+    MapSnapshot update(const Map& map, const DirtyChunks& dirty) const {
+        auto root{std::make_shared<Root>()};
+        root->levelName = map.levelName;
+        root->size = map.size;
+        root->entityCount = map.entities.size();
+        const std::size_t chunkCount{(map.entities.size() + CHUNK_SIZE - 1) / CHUNK_SIZE};
+        root->chunks.reserve(chunkCount);
+        for(std::size_t chunk{}; chunk<chunkCount; ++chunk) {
+            if(chunk < _root->chunks.size() && !dirty.isDirty(chunk) && _root->chunks.at(chunk)->size() == std::min(CHUNK_SIZE, map.entities.size() - chunk*CHUNK_SIZE))
+                root->chunks.push_back(_root->chunks.at(chunk));
+            else
+                root->chunks.push_back(makeChunk(map.entities, chunk));
+        }
+        MapSnapshot result;
+        result._root = root;
+        return result;
+    }
+
+    /**
+        @brief Copies the snapshot into a map, replacing its content.
+        @param map The map to overwrite.
+        @param listener The listener given to the copied entities.
+    */
+    void restore(Map& map, EntityListener* listener = nullptr) const {
+        map.levelName = _root->levelName;
+        map.size = _root->size;
+        map.entities.clear();
+        map.entities.reserve(_root->entityCount);
+        for(const auto& chunk : _root->chunks)
+            for(const MapEntity& entity : *chunk) {
+                map.entities.emplace_back(entity.getType(), entity.getPosition().first, entity.getPosition().second, &map.size);
+                map.entities.back().setListener(listener);
+            }
+    }
+
+    /**
+        @brief Gets the number of entities in the snapshot.
+        @return The number of entities.
+    */
+    std::size_t entityCount() const { return _root->entityCount; }
+
+    /**
+        @brief Gets an entity of the snapshot.
+        @param index The index of the entity.
+        @return The entity, which must not be moved.
+    */
+    const MapEntity& at(std::size_t index) const { return _root->chunks.at(index / CHUNK_SIZE)->at(index % CHUNK_SIZE); }
+
+    /**
+        @brief Gets the dimensions of the map.
+        @return The number of rows and columns.
+    */
+    std::pair<unsigned, unsigned> size() const { return _root->size; }
+
+    /**
+        @brief Gets the name of the level the snapshot was taken from.
+        @return The level name.
+    */
+    const std::string& levelName() const { return _root->levelName; }
+
+    /**
+        @brief Checks whether two snapshots share the storage of a chunk.
+        @param other The other snapshot.
+        @param chunk The index of the chunk.
+        @return true if the chunk is shared, false otherwise.
+    */
+    bool sharesChunk(const MapSnapshot& other, std::size_t chunk) const {
+        return chunk < _root->chunks.size() && chunk < other._root->chunks.size() && _root->chunks.at(chunk) == other._root->chunks.at(chunk);
+    }
+};
+
+#endif // MAPSNAPSHOT_H
@@ -0,0 +1,83 @@
+/**
+    @file Replay.h
+    @brief Defines the Replay class, a recorded game that can be sought to any tick.
+*/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "Core.h"
+#include "DeltaJournal.h"
+#include "Map.h"
+#include "MapSnapshot.h"
+#include <stdexcept>
+#include <vector>
+
+/**
+    @brief A recorded game made of periodic keyframes and of the delta of every tick.
+    @details Seeking restores the closest keyframe before the requested tick and applies
+    the deltas that follow it, so it never applies more than the keyframe interval.
+*/
+class Replay {
+    unsigned _keyframeInterval;
+    std::vector<MapSnapshot> _keyframes;
+    std::vector<TickStep> _steps;
+public:
+    /**
+        @brief Constructs a replay starting from a given map.
+        @param start The map at tick 0.
+        @param keyframeInterval The number of ticks between two keyframes.
+    */
+    Replay(const MapSnapshot& start, unsigned keyframeInterval = 256)
+        : _keyframeInterval{keyframeInterval ? keyframeInterval : 1}, _keyframes{start}, _steps{} {}
+
+    /**
+        @brief Records a tick.
+        @param step How the map changed during the tick.
+        @param map The map at the end of the tick, only copied when a keyframe is due.
+    */
+    void record(const TickStep& step, const MapSnapshot& map) {
+        _steps.push_back(step);
+        if(_steps.size() % _keyframeInterval == 0)
+            _keyframes.push_back(map);
+    }
+
+    /**
+        @brief Records the last tick played by a Core.
+        @param core The Core, right after its update.
+    */
+    void record(const Core& core) {
+        _steps.push_back(core.getLastStep());
+        if(_steps.size() % _keyframeInterval == 0)
+            _keyframes.push_back(core.snapshot());
+    }
+
+    /**
+        @brief Rebuilds the map as it was at a given tick.
+        @param tick The tick, 0 being the start of the replay.
+        @param map The map to overwrite.
+        @throws std::out_of_range If the tick was not recorded.
+    */
+    void seek(std::size_t tick, Map& map) const {
+        if(tick > _steps.size())
+            throw std::out_of_range("Tick "+std::to_string(tick)+" was not recorded");
+        const std::size_t keyframe{tick / _keyframeInterval};
+        _keyframes.at(keyframe).restore(map);
+        for(std::size_t step{keyframe*_keyframeInterval}; step<tick; ++step)
+            _steps.at(step).apply(map);
+    }
+
+    /**
+        @brief Gets the number of recorded ticks.
+        @return The number of ticks.
+    */
+    std::size_t tickCount() const { return _steps.size(); }
+
+    /**
+        @brief Gets the number of ticks between two keyframes.
+        @return The keyframe interval.
+    */
+    unsigned keyframeInterval() const { return _keyframeInterval; }
+};
+
+#endif // REPLAY_H
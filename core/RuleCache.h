@@ -0,0 +1,116 @@
+/**
+    @file RuleCache.h
+    @brief Defines the compiled rule products of a tick and the LRU cache storing them.
+*/
+
+#ifndef RULECACHE_H
+#define RULECACHE_H
+
+#include "MapEntity.h"
+#include "Rules.h"
+#include "RuleTable.h"
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+/**
+    @brief Structure holding everything derived from a set of active sentences.
+*/
+struct CompiledRules {
+    std::vector<Sentence> sentences;
+    std::vector<std::shared_ptr<Rule>> rules;
+    std::map<EntityType, std::set<EntityType>> properties;
+    std::map<EntityType, EntityType> transforms;
+    std::set<EntityType> you;
+};
+
+/**
+    @brief Hit and miss counters of a RuleCache.
+*/
+struct RuleCacheStats {
+    unsigned long long hits;
+    unsigned long long misses;
+
+    /**
+        @brief Computes the ratio of lookups that were served from the cache.
+        @return The hit rate, between 0 and 1.
+    */
+    double hitRate() const {
+        return hits+misses == 0 ? 0. : static_cast<double>(hits)/(hits+misses);
+    }
+};
+
+/**
+    @brief Computes an order-sensitive hash of a list of sentences (FNV-1a).
+    @param sentences The sentences found on the map, in the order they are applied.
+    @return The 64-bit hash of the sentences.
+*/
+inline std::uint64_t hashSentences(const std::vector<Sentence>& sentences) {
+    std::uint64_t hash{14695981039346656037ull};
+    for(const auto& [subject, property] : sentences) {
+        hash = (hash ^ static_cast<std::uint64_t>(subject)) * 1099511628211ull;
+        hash = (hash ^ static_cast<std::uint64_t>(property)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+    @brief A small least-recently-used cache of CompiledRules keyed by the hash of their sentences.
+*/
+class RuleCache {
+    using Entry = std::pair<std::uint64_t, std::shared_ptr<const CompiledRules>>;
+
+    std::size_t _capacity;
+    std::list<Entry> _entries;
+    std::unordered_map<std::uint64_t, std::list<Entry>::iterator> _index;
+    RuleCacheStats _stats;
+public:
+    /**
+        @brief Constructs an empty cache.
+        @param capacity The maximum number of compiled rule sets kept in memory.
+    */
+    RuleCache(std::size_t capacity = 16) : _capacity{capacity ? capacity : 1}, _stats{} {}
+
+    /**
+        @brief Looks up the compiled products of a sentence list, compiling them on a miss.
+        @param sentences The sentences found on the map.
+        @param compile Callable turning the sentences into a CompiledRules object, only invoked on a miss.
+        @return The compiled products, shared with the cache.
+    */
+    template<typename Compiler>
+    std::shared_ptr<const CompiledRules> get(const std::vector<Sentence>& sentences, Compiler compile) {
+        const std::uint64_t hash{hashSentences(sentences)};
+        auto found{_index.find(hash)};
+        if(found != std::end(_index) && found->second->second->sentences == sentences) {
+            ++_stats.hits;
+            _entries.splice(std::begin(_entries), _entries, found->second);
+            return found->second->second;
+        }
+
+        ++_stats.misses;
+        std::shared_ptr<const CompiledRules> compiled{std::make_shared<CompiledRules>(compile(sentences))};
+        if(found != std::end(_index)) {
+            _entries.erase(found->second);
+            _index.erase(found);
+        }
+        else if(_entries.size() >= _capacity) {
+            _index.erase(_entries.back().first);
+            _entries.pop_back();
+        }
+        _entries.emplace_front(hash, compiled);
+        _index[hash] = std::begin(_entries);
+        return compiled;
+    }
+
+    /**
+        @brief Gets the hit and miss counters of the cache.
+        @return The counters.
+    */
+    const RuleCacheStats& getStats() const { return _stats; }
+};
+
+#endif // RULECACHE_H
@@ -0,0 +1,100 @@
+/**
+    @file RuleTable.h
+    @brief Defines the table of the rules of the game, shared by every engine applying them.
+*/
+
+#ifndef RULETABLE_H
+#define RULETABLE_H
+
+#include "MapEntity.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+    @typedef Sentence
+    @brief A pair of EntityType values representing a "SUBJECT IS PROPERTY" sentence found on the map.
+*/
+using Sentence = std::pair<EntityType, EntityType>;
+
+/**
+    @brief Namespace containing the vocabulary of the rules: the texts forming sentences, the texts
+    always pushable and the effect of each property.
+    @details Three engines apply the rules. Core uses the Rule objects of Rules.h, the reference
+    implementation, on its observed map. Simulation::step replays them on plain data for the solvers,
+    and BatchSimulation on many games at once. All three read the sentences, order the permanent
+    rules and dispatch the properties through this table alone, so a new text or property is only
+    declared here. Each engine then implements every effect for its own data layout; the
+    "Simulation step tests" and "Batch simulation tests" check that they play alike with Core.
+*/
+namespace RuleTable {
+/**
+    @brief The number of entity types, used to size lookup tables indexed by EntityType.
+*/
+constexpr std::size_t TYPE_COUNT{BEST+1};
+
+/**
+    @brief What a sentence does to the entities of its subject.
+*/
+enum class Effect : std::uint8_t { YOU, STOP, PUSH, WIN, KILL, SINK, TRANSFORM };
+
+/**
+    @brief The noun designated by each text entity, NONE for the other types.
+*/
+constexpr std::array<EntityType, TYPE_COUNT> subjectOf{[] {
+    std::array<EntityType, TYPE_COUNT> result{};
+    result.fill(NONE);
+    for(int text{TEXT_ROCK}; text<=TEXT_BABA; ++text) { result[text] = static_cast<EntityType>(ROCK + text - TEXT_ROCK); }
+    return result;
+}()};
+
+/**
+    @brief The property or noun designated by each text entity, NONE for the other types.
+*/
+constexpr std::array<EntityType, TYPE_COUNT> propertyOf{[] {
+    std::array<EntityType, TYPE_COUNT> result{subjectOf};
+    for(int text{YOU}; text<=SINK; ++text) { result[text] = static_cast<EntityType>(text); }
+    result[IS] = IS;
+    return result;
+}()};
+
+/**
+    @brief The effect of each property; nouns and IS turn the subject into them.
+*/
+constexpr std::array<Effect, TYPE_COUNT> effectOf{[] {
+    std::array<Effect, TYPE_COUNT> result{};
+    result.fill(Effect::TRANSFORM);
+    result[YOU] = Effect::YOU;
+    result[STOP] = Effect::STOP;
+    result[PUSH] = Effect::PUSH;
+    result[WIN] = Effect::WIN;
+    result[KILL] = Effect::KILL;
+    result[SINK] = Effect::SINK;
+    return result;
+}()};
+
+/**
+    @brief The text entities which are always pushable, in the order their permanent rules are applied.
+*/
+constexpr EntityType permanentPush[]{
+    TEXT_BABA, TEXT_FLAG, TEXT_GRASS, TEXT_LAVA, TEXT_METAL, TEXT_ROCK, TEXT_WATER, TEXT_WALL,
+    YOU, STOP, PUSH, WIN, KILL, SINK, IS, BEST
+};
+
+/**
+    @brief Checks whether a sentence can be read on a map.
+    @param sentence The sentence.
+    @return true if its subject is a noun and its property a noun, a property or IS, false otherwise.
+*/
+constexpr bool isSentence(const Sentence& sentence) {
+    auto named{[](const std::array<EntityType, TYPE_COUNT>& table, EntityType type) {
+        for(EntityType entry : table)
+            if(entry != NONE && entry == type) { return true; }
+        return false;
+    }};
+    return named(subjectOf, sentence.first) && named(propertyOf, sentence.second);
+}
+};
+
+#endif // RULETABLE_H
@@ -6,8 +6,22 @@
 #define RULES_H
 
 #include <algorithm>
+#include <vector>
 #include "MapEntity.h"
 
+/**
+    @brief Erases the flagged entities from a map, last one first, notifying each of them beforehand.
+    @param map A reference to a vector of MapEntity objects.
+    @param toRemove A flag per entity of the map, true for the entities to erase.
+*/
+inline void eraseEntities(std::vector<MapEntity>& map, const std::vector<bool>& toRemove) {
+    for(unsigned i=map.size(); i-- > 0;) {
+        if(!toRemove.at(i)) { continue; }
+        map.at(i).notifyRemoval();
+        map.erase(std::begin(map)+i);
+    }
+}
+
 /**
     @brief The Rule class represents a rule that can be applied to a map.
     A Rule is defined by a subject EntityType and an algorithm
@@ -50,14 +64,9 @@ public:
     */
     bool apply(std::vector<MapEntity>& map) override {
         std::vector<Position> positions;
-        auto found{std::begin(map)};
-        do {
-            found = std::find_if(found+1, std::end(map), [&](const MapEntity& entity) {
-                return entity.getType() == _subject;
-            });
-            if(found != std::end(map))
-                positions.push_back(found->getPosition());
-        } while(found != std::end(map));
+        for(const MapEntity& entity : map)
+            if(entity.getType() == _subject)
+                positions.push_back(entity.getPosition());
 
         for(Position p : positions) {
             for(MapEntity& ent : map) {
@@ -129,11 +138,13 @@ public:
             if(entity.getType() == _subject)
                 positions.push_back(entity.getPosition());
 
+        std::vector<bool> toRemove(map.size());
         for(Position pos : positions) {
-            std::remove_if(std::begin(map), std::end(map), [&](const MapEntity& entity) {
-                return entity.getPosition() == pos && entity.getType() != _subject;
-            });
+            for(unsigned i=0; i<map.size(); ++i)
+                if(map.at(i).getPosition() == pos && map.at(i).getType() != _subject)
+                    toRemove.at(i) = true;
         }
+        eraseEntities(map, toRemove);
         return false;
     }
 };
@@ -160,22 +171,16 @@ public:
             if(map.at(i).getType() == _subject)
                 positions.push_back(i);
 
-        std::vector<decltype(std::begin(map))> toRemove{};
+        std::vector<bool> toRemove(map.size());
         for(unsigned pos : positions) {
-            auto found{std::begin(map)};
-            do {
-                found = std::find_if(found+1, std::end(map), [&](const MapEntity& entity){
-                    return entity.getPosition() == map.at(pos).getPosition() && entity.getType() != _subject;
-                });
-                if(found != std::end(map)) {
-                    toRemove.push_back(found);
-                    toRemove.push_back(std::begin(map)+pos-1);
+            for(unsigned i=0; i<map.size(); ++i) {
+                if(map.at(i).getPosition() == map.at(pos).getPosition() && map.at(i).getType() != _subject) {
+                    toRemove.at(i) = true;
+                    toRemove.at(pos) = true;
                 }
-            } while(found != std::end(map));
+            }
         }
-        for(auto x : toRemove)
-            map.erase(x);
-
+        eraseEntities(map, toRemove);
         return false;
     }
 };
@@ -228,10 +233,12 @@ public:
     IsYou(EntityType subject, EntityType* playerEntity) : Rule(subject), _playerEntity{playerEntity} {}
     /**
         @brief Sets the player-controlled entity.
+        @details When several sentences make entities YOU, the first subject in EntityType order is
+        kept whatever the order of the sentences, so that applying them again changes nothing.
         @param map (unused) A vector of MapEntity objects representing the map.
     */
     bool apply(std::vector<MapEntity>& map) override {
-        if(*_playerEntity == _subject) return false;
+        if(*_playerEntity <= _subject) return false;
         *_playerEntity = _subject;
         return true;
     }
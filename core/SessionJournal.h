@@ -0,0 +1,141 @@
+/**
+    @file SessionJournal.h
+    @brief Defines the SessionJournal class, a write-ahead log of the inputs of a game session.
+*/
+
+#ifndef SESSIONJOURNAL_H
+#define SESSIONJOURNAL_H
+
+#include "Map.h"
+#include "MapSnapshot.h"
+#include "Utils.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+    @brief A write-ahead journal of the inputs of a session, compacted by periodic snapshots.
+    @details The journal directory holds two files: session.snapshot, the map at the time of
+    the last snapshot, and session.log, every input accepted since that snapshot. Both start
+    with a generation number and the path of the level being played; a log is only replayed
+    on top of the snapshot of the same generation. Recovering a session thus never replays
+    more inputs than the snapshot interval.
+
+    The files are written by a background thread, in the order the inputs and snapshots were
+    given, so the game loop never waits for the disk. The first write which fails stops the
+    journal: the writes after it are dropped, and failed() tells the game to go on without it.
+*/
+class SessionJournal {
+    // A write waiting for the writer thread
+    struct Write {
+        enum Kind { INPUT, SNAPSHOT, DISCARD } kind;
+        UserInput input{UserInput::NONE};
+        MapSnapshot map{};
+    };
+
+    std::filesystem::path _directory;
+    std::string _levelPath;
+    unsigned _snapshotInterval;
+    unsigned _sinceSnapshot;
+    unsigned long _generation; // Only used by the writer thread once it started
+    std::ofstream _log;
+
+    std::mutex _mutex;
+    std::condition_variable _queued;
+    std::condition_variable _written;
+    std::deque<Write> _writes;
+    bool _writing{};
+    bool _stopping{};
+    std::atomic<bool> _failed{};
+    std::thread _writer;
+
+    std::filesystem::path logPath() const;
+    std::filesystem::path snapshotPath() const;
+    void openLog();
+    void queue(Write write);
+    void run();
+    void perform(const Write& write);
+public:
+    /**
+        @brief State found in the journal directory of an interrupted session.
+    */
+    struct Recovery {
+        std::optional<MapSnapshot> snapshot;
+        std::vector<UserInput> inputs;
+    };
+
+    /**
+        @brief Constructs a journal, without touching the files of a previous session.
+        @param directory The directory holding the journal files, created if needed.
+        @param levelPath The path of the level played during the session.
+        @param snapshotInterval The number of journalled inputs between two snapshots.
+        @throws std::filesystem::filesystem_error If the directory can't be created.
+    */
+    SessionJournal(const std::string& directory, const std::string& levelPath, unsigned snapshotInterval = 64);
+
+    /**
+        @brief Writes the pending inputs and snapshots, then stops the writer thread if it was started.
+    */
+    ~SessionJournal();
+
+    SessionJournal(const SessionJournal&) = delete;
+    SessionJournal& operator=(const SessionJournal&) = delete;
+
+    /**
+        @brief Reads what an interrupted session of the same level left in the journal directory.
+        @details The next snapshot written by this journal supersedes the recovered one.
+        @return The last snapshot, if any, and the inputs accepted after it.
+        @throws std::invalid_argument If the snapshot file is corrupted.
+    */
+    Recovery recover();
+
+    /**
+        @brief Queues an input, appended to the log and flushed by the writer thread.
+        @param input The accepted input.
+    */
+    void append(UserInput input);
+
+    /**
+        @brief Checks whether enough inputs were journalled since the last snapshot.
+        @return true if a snapshot should be written, false otherwise.
+    */
+    bool snapshotDue() const;
+
+    /**
+        @brief Makes a snapshot due, for changes that cannot be replayed from the log.
+    */
+    void requestSnapshot();
+
+    /**
+        @brief Queues a snapshot of the map, after which the writer thread starts a new empty log.
+        @details The snapshot is written to a temporary file renamed over the previous one,
+        so a crash while writing leaves the previous snapshot and log intact.
+        @param map The current map, which the game may change meanwhile.
+    */
+    void writeSnapshot(MapSnapshot map);
+
+    /**
+        @brief Queues the deletion of the journal files once the session ended normally.
+    */
+    void discard();
+
+    /**
+        @brief Blocks until every queued write is done.
+    */
+    void flush();
+
+    /**
+        @brief Checks whether a write failed, after which nothing more is journalled.
+        @return true if the journal stopped, false otherwise.
+    */
+    bool failed() const;
+};
+
+#endif // SESSIONJOURNAL_H
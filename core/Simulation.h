@@ -0,0 +1,95 @@
+/**
+    @file Simulation.h
+    @brief Defines a plain-data game state and a pure step function advancing it, without observers nor I/O.
+*/
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "CoreState.h"
+#include "Map.h"
+#include "MapEntity.h"
+#include "RuleCache.h"
+#include "RuleTable.h"
+#include "Utils.h"
+#include <cstdint>
+#include <vector>
+
+/**
+    @brief Namespace containing the headless simulation of the game.
+    @details step() follows exactly the rules applied by Core::manageInput followed by Core::update,
+    but works on plain data: no virtual rule objects, no listeners, no observers and no files.
+    Once the output state has reached its capacity, stepping never allocates.
+
+    The Rule objects of Rules.h used by Core are the reference: step() reads the sentences and
+    dispatches them through RuleTable like Core does, and reimplements each effect on plain data.
+    The "Simulation step tests" check that both play every level alike.
+*/
+namespace Simulation {
+/**
+    @brief An entity of a simulated map.
+*/
+struct Entity {
+    std::int16_t row;
+    std::int16_t col;
+    std::uint8_t type;
+    std::int8_t dRow;
+    std::int8_t dCol;
+    std::uint8_t flags;
+};
+
+/**
+    @brief A game state as plain data.
+*/
+struct State {
+    std::int16_t rows{};
+    std::int16_t cols{};
+    EntityType player{NONE};
+    bool gameOver{};
+    std::vector<Entity> entities;
+    std::vector<Sentence> rules;
+    const State* initial{};
+};
+
+/**
+    @brief Advances a state by one input, as Core::manageInput followed by Core::update would.
+    @details RESET restores the state pointed by State::initial, QUIT ends the game, and SAVE, UNDO
+    and REDO, which need the outside world or a history, leave the map unchanged.
+    @param in The current state, which can be the same object as out.
+    @param input The user input.
+    @param out The state after the input; its buffers are reused.
+*/
+void step(const State& in, UserInput input, State& out);
+
+/**
+    @brief Builds a state from a map.
+    @param map The map.
+    @param player The entity type controlled by the player.
+    @return The state.
+*/
+State fromMap(const Map& map, EntityType player = NONE);
+
+/**
+    @brief Builds a state from the saved state of a Core.
+    @param state The saved state.
+    @param initial The state to fill with the initial map, which State::initial will point to.
+    @return The current state.
+*/
+State fromCoreState(const CoreState& state, State& initial);
+
+/**
+    @brief Copies a state into a map, replacing its content.
+    @param state The state.
+    @param map The map to overwrite.
+*/
+void toMap(const State& state, Map& map);
+
+/**
+    @brief Computes the Zobrist hash of a state, equal to Core::stateHash for the same game.
+    @param state The state.
+    @return The 64-bit hash.
+*/
+std::uint64_t hash(const State& state);
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,109 @@
+/**
+    @file TransitionCache.h
+    @brief Defines the TransitionCache class, which memoizes Simulation::step.
+*/
+
+#ifndef TRANSITIONCACHE_H
+#define TRANSITIONCACHE_H
+
+#include "Simulation.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+/**
+    @brief Counters of a TransitionCache.
+*/
+struct TransitionCacheStats {
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+    std::size_t bytes;
+
+    /**
+        @brief Computes the ratio of steps that were served from the cache.
+        @return The hit rate, between 0 and 1.
+    */
+    double hitRate() const {
+        return hits+misses == 0 ? 0. : static_cast<double>(hits)/(hits+misses);
+    }
+};
+
+/**
+    @brief A bounded least-recently-used cache of the successors of states, keyed by (state hash, input).
+    @details A transition is identified by the Zobrist hash of the state, a second order-sensitive hash
+    of everything else step() reads (the entity order, the map size, gameOver and State::initial),
+    and the input. The successor is stored as a delta: the entities that differ from the state,
+    or the whole entity list when the step added, removed or changed most of them, plus the rules,
+    the player and gameOver. The oldest transitions are evicted once the memory cap is reached.
+*/
+class TransitionCache {
+    struct Key {
+        std::uint64_t hash;
+        std::uint64_t check;
+        UserInput input;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const { return key.hash ^ key.check ^ static_cast<std::size_t>(key.input); }
+    };
+
+    struct Transition {
+        Key key;
+        bool replaced; // entities holds every entity of the successor, otherwise only those at indices
+        std::int16_t rows;
+        std::int16_t cols;
+        EntityType player;
+        bool gameOver;
+        std::vector<std::uint32_t> indices;
+        std::vector<Simulation::Entity> entities;
+        std::vector<Sentence> rules;
+    };
+
+    std::size_t _maxBytes;
+    std::list<Transition> _transitions;
+    std::unordered_map<Key, std::list<Transition>::iterator, KeyHash> _index;
+    TransitionCacheStats _stats{};
+
+    static std::uint64_t check(const Simulation::State& state);
+    static std::size_t bytes(const Transition& transition);
+    static void apply(const Transition& transition, const Simulation::State& in, Simulation::State& out);
+    void store(const Key& key, const Simulation::State& in, const Simulation::State& out);
+public:
+    /**
+        @brief Constructs an empty cache.
+        @param maxBytes The memory the stored transitions may use, approximately.
+    */
+    explicit TransitionCache(std::size_t maxBytes = 64 << 20) : _maxBytes{maxBytes} {}
+
+    /**
+        @brief Advances a state by one input, as Simulation::step would, reusing a stored successor when there is one.
+        @param in The current state, which can be the same object as out.
+        @param input The user input.
+        @param out The state after the input; its buffers are reused.
+    */
+    void step(const Simulation::State& in, UserInput input, Simulation::State& out);
+
+    /**
+        @brief Gets the number of stored transitions.
+        @return The number of transitions.
+    */
+    std::size_t size() const { return _transitions.size(); }
+
+    /**
+        @brief Forgets every stored transition, keeping the counters.
+    */
+    void clear();
+
+    /**
+        @brief Gets the counters of the cache.
+        @return The hits, misses, evictions and the memory used by the stored transitions.
+    */
+    const TransitionCacheStats& getStats() const { return _stats; }
+};
+
+#endif // TRANSITIONCACHE_H
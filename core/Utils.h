@@ -59,7 +59,47 @@ constexpr Position operator+(Position pos, Direction dir) {
 */
 enum class UserInput {
     UP, DOWN, LEFT, RIGHT,
-    RESET, SAVE, QUIT,
+    RESET, UNDO, REDO, SAVE, QUIT,
     NONE
 };
+
+/**
+    @brief Converts a user input to the character representing it in input scripts and journals.
+    @param input The user input.
+    @return The character (U, D, L, R, X for reset, Z for undo, Y for redo, S, Q, or '.' for none).
+*/
+constexpr char inputToChar(UserInput input) {
+    switch(input) {
+        case UserInput::UP: return 'U';
+        case UserInput::DOWN: return 'D';
+        case UserInput::LEFT: return 'L';
+        case UserInput::RIGHT: return 'R';
+        case UserInput::RESET: return 'X';
+        case UserInput::UNDO: return 'Z';
+        case UserInput::REDO: return 'Y';
+        case UserInput::SAVE: return 'S';
+        case UserInput::QUIT: return 'Q';
+        default: return '.';
+    }
+}
+
+/**
+    @brief Converts a character of an input script or journal to a user input.
+    @param c The character, as returned by inputToChar.
+    @return The user input, UserInput::NONE for unknown characters.
+*/
+constexpr UserInput charToInput(char c) {
+    switch(c) {
+        case 'U': return UserInput::UP;
+        case 'D': return UserInput::DOWN;
+        case 'L': return UserInput::LEFT;
+        case 'R': return UserInput::RIGHT;
+        case 'X': return UserInput::RESET;
+        case 'Z': return UserInput::UNDO;
+        case 'Y': return UserInput::REDO;
+        case 'S': return UserInput::SAVE;
+        case 'Q': return UserInput::QUIT;
+        default: return UserInput::NONE;
+    }
+}
 #endif // UTILS_H
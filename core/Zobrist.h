@@ -0,0 +1,67 @@
+/**
+    @file Zobrist.h
+    @brief Defines the keys used to hash game states.
+*/
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "MapEntity.h"
+#include "Utils.h"
+#include <cstdint>
+#include <vector>
+
+/**
+    @brief Namespace containing the Zobrist keys of the game.
+    @details Every (EntityType, cell) pair has a pseudo-random 64-bit key, and the hash of a state
+    is the sum of the keys of its entities plus the key of the player entity. Keys are derived
+    from their coordinates with splitmix64 instead of being stored in a table, so they do not
+    depend on the map size and are identical across runs. The keys are added rather than xored
+    so that two identical entities on the same cell don't cancel out.
+*/
+namespace Zobrist {
+/**
+    @brief Mixes a 64-bit value (splitmix64 finalizer).
+    @param x The value to mix.
+    @return The mixed value.
+*/
+constexpr std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/**
+    @brief Gets the key of an entity type on a cell.
+    @param type The type of the entity.
+    @param position The cell.
+    @return The key.
+*/
+constexpr std::uint64_t key(EntityType type, Position position) {
+    return mix((static_cast<std::uint64_t>(type) << 48) ^ (static_cast<std::uint64_t>(position.first & 0xffffff) << 24) ^ (position.second & 0xffffff));
+}
+
+/**
+    @brief Gets the key of the entity type controlled by the player.
+    @param playerEntity The type of the player entity.
+    @return The key.
+*/
+constexpr std::uint64_t playerKey(EntityType playerEntity) {
+    return mix(0xffull << 56 | static_cast<std::uint64_t>(playerEntity));
+}
+
+/**
+    @brief Hashes the entities of a map from scratch.
+    @param entities The entities.
+    @return The sum of the keys of the entities.
+*/
+inline std::uint64_t hash(const std::vector<MapEntity>& entities) {
+    std::uint64_t result{};
+    for(const MapEntity& entity : entities)
+        result += key(entity.getType(), entity.getPosition());
+    return result;
+}
+};
+
+#endif // ZOBRIST_H
@@ -0,0 +1,71 @@
+#include "../AsyncSaver.h"
+#include "../CoreState.h"
+#include "../Map.h"
+
+AsyncSaver::~AsyncSaver() {
+    if(!_writer.joinable()) { return; }
+    {
+        std::lock_guard lock{_mutex};
+        _stopping = true;
+    }
+    _requested.notify_one();
+    _writer.join();
+}
+
+void AsyncSaver::save(Request request) {
+    {
+        std::lock_guard lock{_mutex};
+        _requests.push_back(std::move(request));
+        if(!_writer.joinable()) { _writer = std::thread{&AsyncSaver::run, this}; }
+    }
+    _requested.notify_one();
+}
+
+void AsyncSaver::flush() {
+    std::unique_lock lock{_mutex};
+    _written.wait(lock, [this] { return _requests.empty() && !_writing; });
+}
+
+std::size_t AsyncSaver::failures() const {
+    std::lock_guard lock{_mutex};
+    return _failures;
+}
+
+std::string AsyncSaver::lastError() const {
+    std::lock_guard lock{_mutex};
+    return _lastError;
+}
+
+void AsyncSaver::run() {
+    std::unique_lock lock{_mutex};
+    while(true) {
+        _requested.wait(lock, [this] { return _stopping || !_requests.empty(); });
+        if(_requests.empty()) { return; }
+
+        Request request{std::move(_requests.front())};
+        _requests.pop_front();
+        _writing = true;
+        lock.unlock();
+        std::string error;
+        // A failed save must not take the game down
+        try { write(request); }
+        catch(const std::exception& e) { error = e.what(); }
+        lock.lock();
+        if(!error.empty()) {
+            ++_failures;
+            _lastError = std::move(error);
+        }
+        _writing = false;
+        _written.notify_all();
+    }
+}
+
+void AsyncSaver::write(const Request& request) {
+    Map map;
+    request.map.restore(map);
+    const std::string filePath{LevelLoader::saveLevel(map, request.time, request.directory)};
+    BinarySnapshot::save(filePath.substr(0, filePath.size()-4)+".state", CoreState{
+        map.levelName, map.size, CoreState::pack(map.entities), CoreState::pack(request.initialMap),
+        request.playerEntity, request.gameOver, request.rules
+    });
+}
@@ -0,0 +1,78 @@
+#include "../BatchEnvironment.h"
+#include <algorithm>
+#include <stdexcept>
+
+BatchEnvironment::BatchEnvironment(const std::vector<Simulation::State>& levels, std::size_t envs, std::size_t maxSteps, std::size_t threads)
+    : _levels{levels}, _maxSteps{maxSteps}, _pool{threads} {
+    if(levels.empty()) { throw std::invalid_argument("No level"); }
+    if(!envs) { throw std::invalid_argument("No environment"); }
+    // Moves never leave the map, so checking the levels once keeps every observation within its tensor
+    for(const Simulation::State& level : levels)
+        for(const Simulation::Entity& entity : level.entities)
+            if(entity.row < 0 || entity.col < 0 || entity.row >= level.rows || entity.col >= level.cols || entity.type >= PLANES)
+                throw std::invalid_argument("Entity out of its level: "+std::to_string(entity.row)+" "+std::to_string(entity.col));
+
+    // _levels doesn't grow anymore, so the starts can point to it for RESET
+    _starts = _levels;
+    for(std::size_t level{}; level<_levels.size(); ++level) {
+        _starts[level].initial = &_levels[level];
+        Simulation::step(_starts[level], UserInput::NONE, _starts[level]);
+        _rows = std::max(_rows, _levels[level].rows);
+        _cols = std::max(_cols, _levels[level].cols);
+    }
+    _states.reserve(envs);
+    for(std::size_t env{}; env<envs; ++env)
+        _states.push_back(_starts[env % _starts.size()]);
+    _steps.resize(envs);
+}
+
+void BatchEnvironment::check(std::span<std::uint8_t> observations) const {
+    if(observations.size() != observationSize())
+        throw std::invalid_argument("The observation tensor doesn't match the environments");
+}
+
+void BatchEnvironment::reset(std::size_t env, std::uint8_t* observation) {
+    _states[env] = _starts[env % _starts.size()];
+    _steps[env] = 0;
+    observe(env, observation);
+}
+
+void BatchEnvironment::observe(std::size_t env, std::uint8_t* observation) const {
+    const std::size_t plane{rows()*cols()};
+    std::fill_n(observation, PLANES*plane, 0);
+    for(const Simulation::Entity& entity : _states[env].entities)
+        observation[entity.type*plane + entity.row*cols() + entity.col] = 1;
+}
+
+void BatchEnvironment::reset(std::span<std::uint8_t> observations) {
+    check(observations);
+    const std::size_t stride{PLANES*rows()*cols()};
+    _pool.parallelFor(size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t env{begin}; env<end; ++env)
+            reset(env, observations.data() + env*stride);
+    });
+}
+
+void BatchEnvironment::step(std::span<const UserInput> actions, std::span<std::uint8_t> observations, std::span<float> rewards, std::span<std::uint8_t> dones) {
+    if(actions.size() != size() || rewards.size() != size() || dones.size() != size())
+        throw std::invalid_argument("There must be one action, reward and done per environment");
+    check(observations);
+    const std::size_t stride{PLANES*rows()*cols()};
+    _pool.parallelFor(size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t env{begin}; env<end; ++env) {
+            Simulation::State& state{_states[env]};
+            Simulation::step(state, actions[env], state);
+            ++_steps[env];
+
+            const bool controlled{std::any_of(state.entities.begin(), state.entities.end(), [&](const Simulation::Entity& entity) {
+                return entity.type == state.player;
+            })};
+            const bool won{state.gameOver && actions[env] != UserInput::QUIT};
+            rewards[env] = won ? 1.f : controlled ? 0.f : -1.f;
+            dones[env] = won || !controlled || state.gameOver || (_maxSteps && _steps[env] >= _maxSteps);
+
+            if(dones[env]) { reset(env, observations.data() + env*stride); }
+            else { observe(env, observations.data() + env*stride); }
+        }
+    });
+}
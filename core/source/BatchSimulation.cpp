@@ -0,0 +1,437 @@
+#include "../BatchSimulation.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+constexpr std::size_t LANES{BatchSimulation::LANES};
+using Lane8 = std::uint8_t;
+using Lane16 = std::int16_t;
+
+// Loops over the games of a block. Their arguments never alias, which lets the compiler vectorize
+// them, and they are kept out of line so that this guarantee survives inlining.
+[[gnu::noinline]] Lane8 selectLanes(Lane8* __restrict selected, const Lane8* __restrict mask, const Lane8* __restrict alive, const Lane8* __restrict type, const Lane8* __restrict subject) {
+    Lane8 result{};
+    for(std::size_t g{}; g<LANES; ++g) {
+        selected[g] = mask[g] & alive[g] & (type[g] == subject[g]);
+        result |= selected[g];
+    }
+    return result;
+}
+
+[[gnu::noinline]] Lane8 moveLanes(Lane16* __restrict row, Lane16* __restrict col, Lane16* __restrict dRow, Lane16* __restrict dCol, const Lane8* __restrict alive, const Lane8* __restrict type,
+                                  const Lane8* __restrict player, const Lane16* __restrict inputRow, const Lane16* __restrict inputCol, Lane16 rows, Lane16 cols) {
+    Lane8 result{};
+    for(std::size_t g{}; g<LANES; ++g) {
+        const Lane16 newRow(row[g] + inputRow[g]), newCol(col[g] + inputCol[g]);
+        const bool moves(alive[g] & (type[g] == player[g]) & (newRow >= 0) & (newCol >= 0) & (newRow < rows) & (newCol < cols));
+        row[g] = moves ? newRow : row[g];
+        col[g] = moves ? newCol : col[g];
+        dRow[g] = moves ? inputRow[g] : 0;
+        dCol[g] = moves ? inputCol[g] : 0;
+        result |= moves & ((inputRow[g] | inputCol[g]) != 0);
+    }
+    return result;
+}
+
+[[gnu::noinline]] void resetLanes(Lane16* __restrict row, Lane16* __restrict col, Lane8* __restrict type, Lane8* __restrict alive, const Lane8* __restrict reset,
+                                  Lane16 initialRow, Lane16 initialCol, Lane8 initialType, Lane8 initialAlive) {
+    for(std::size_t g{}; g<LANES; ++g) {
+        row[g] = reset[g] ? initialRow : row[g];
+        col[g] = reset[g] ? initialCol : col[g];
+        type[g] = reset[g] ? initialType : type[g];
+        alive[g] = reset[g] ? initialAlive : alive[g];
+    }
+}
+
+// Tells whether an entity is a text which can be part of a sentence in any game
+[[gnu::noinline]] Lane8 wordLanes(const Lane8* __restrict type, const Lane8* __restrict alive, const EntityType* __restrict lookup) {
+    Lane8 result{};
+    for(std::size_t g{}; g<LANES; ++g) { result |= alive[g] & (lookup[type[g]] != NONE); }
+    return result;
+}
+
+[[gnu::noinline]] void findTextLanes(Lane8* __restrict text, const Lane8* __restrict selected, const Lane16* __restrict isRow, const Lane16* __restrict isCol, int dRow, int dCol,
+                                     const Lane16* __restrict row, const Lane16* __restrict col, const Lane8* __restrict type, const Lane8* __restrict alive, const EntityType* __restrict lookup) {
+    for(std::size_t g{}; g<LANES; ++g) {
+        const bool hit(selected[g] & alive[g] & (text[g] == NONE) & (row[g] == isRow[g]+dRow) & (col[g] == isCol[g]+dCol));
+        text[g] = hit ? static_cast<Lane8>(lookup[type[g]]) : text[g];
+    }
+}
+
+[[gnu::noinline]] void findPusherLanes(std::int32_t* __restrict found, Lane16* __restrict foundRow, Lane16* __restrict foundCol, const Lane8* __restrict selected,
+                                       const Lane16* __restrict row, const Lane16* __restrict col, const Lane16* __restrict otherRow, const Lane16* __restrict otherCol,
+                                       const Lane16* __restrict otherDRow, const Lane16* __restrict otherDCol, const Lane8* __restrict otherAlive, std::int32_t other) {
+    for(std::size_t g{}; g<LANES; ++g) {
+        const bool hit(selected[g] & (found[g] < 0) & otherAlive[g] & (otherRow[g] == row[g]) & (otherCol[g] == col[g]) & ((otherDRow[g] | otherDCol[g]) != 0));
+        found[g] = hit ? other : found[g];
+        foundRow[g] = hit ? otherDRow[g] : foundRow[g];
+        foundCol[g] = hit ? otherDCol[g] : foundCol[g];
+    }
+}
+
+[[gnu::noinline]] Lane8 pushAlongLanes(Lane16* __restrict row, Lane16* __restrict col, Lane16* __restrict dRow, Lane16* __restrict dCol, std::int32_t* __restrict found,
+                                       const Lane16* __restrict foundRow, const Lane16* __restrict foundCol, Lane8* __restrict changed, Lane16 rows, Lane16 cols) {
+    Lane8 result{};
+    for(std::size_t g{}; g<LANES; ++g) {
+        const Lane16 newRow(row[g] + foundRow[g]), newCol(col[g] + foundCol[g]);
+        const bool hasFound{found[g] >= 0};
+        const bool moves(hasFound & (dRow[g] == 0) & (dCol[g] == 0) & (newRow >= 0) & (newCol >= 0) & (newRow < rows) & (newCol < cols));
+        row[g] = moves ? newRow : row[g];
+        col[g] = moves ? newCol : col[g];
+        dRow[g] = moves ? foundRow[g] : dRow[g];
+        dCol[g] = moves ? foundCol[g] : dCol[g];
+        changed[g] |= moves;
+        result |= moves;
+        // Only the pushers left in found bounce back
+        found[g] = hasFound & !moves ? found[g] : -1;
+    }
+    return result;
+}
+
+// Moves back an entity in the selected games, reversing its direction
+[[gnu::noinline]] void bounceLanes(Lane16* __restrict row, Lane16* __restrict col, Lane16* __restrict dRow, Lane16* __restrict dCol, const Lane8* __restrict bounces) {
+    for(std::size_t g{}; g<LANES; ++g) {
+        row[g] = bounces[g] ? row[g] - dRow[g] : row[g];
+        col[g] = bounces[g] ? col[g] - dCol[g] : col[g];
+        dRow[g] = bounces[g] ? -dRow[g] : dRow[g];
+        dCol[g] = bounces[g] ? -dCol[g] : dCol[g];
+    }
+}
+
+// Selects the games in which an entity is the pusher to bounce back
+[[gnu::noinline]] Lane8 pushersLanes(Lane8* __restrict bounces, const std::int32_t* __restrict found, std::int32_t other) {
+    Lane8 result{};
+    for(std::size_t g{}; g<LANES; ++g) {
+        bounces[g] = found[g] == other;
+        result |= bounces[g];
+    }
+    return result;
+}
+
+// Marks the entities of another type sharing the cell of the selected entities
+[[gnu::noinline]] Lane8 sharedCellLanes(Lane8* __restrict hit, const Lane8* __restrict selected, const Lane8* __restrict subject, const Lane16* __restrict cellRow, const Lane16* __restrict cellCol,
+                                        const Lane16* __restrict row, const Lane16* __restrict col, const Lane8* __restrict type, const Lane8* __restrict alive) {
+    Lane8 result{};
+    for(std::size_t g{}; g<LANES; ++g) {
+        hit[g] = selected[g] & alive[g] & (type[g] != subject[g]) & (row[g] == cellRow[g]) & (col[g] == cellCol[g]);
+        result |= hit[g];
+    }
+    return result;
+}
+
+[[gnu::noinline]] void winLanes(Lane8* __restrict gameOver, const Lane8* __restrict selected, const Lane8* __restrict subject, const Lane16* __restrict playerRow, const Lane16* __restrict playerCol,
+                                const Lane16* __restrict row, const Lane16* __restrict col, const Lane8* __restrict type, const Lane8* __restrict alive) {
+    for(std::size_t g{}; g<LANES; ++g)
+        gameOver[g] |= selected[g] & alive[g] & (type[g] == subject[g]) & (row[g] == playerRow[g]) & (col[g] == playerCol[g]);
+}
+
+[[gnu::noinline]] void orLanes(Lane8* __restrict lanes, const Lane8* __restrict other) {
+    for(std::size_t g{}; g<LANES; ++g) { lanes[g] |= other[g]; }
+}
+
+[[gnu::noinline]] void clearLanes(Lane8* __restrict lanes, const Lane8* __restrict cleared, std::size_t size) {
+    for(std::size_t i{}; i<size; ++i) { lanes[i] &= !cleared[i]; }
+}
+
+[[gnu::noinline]] void youLanes(Lane8* __restrict player, Lane8* __restrict changed, const Lane8* __restrict mask, const Lane8* __restrict subject) {
+    for(std::size_t g{}; g<LANES; ++g) {
+        const bool changes(mask[g] & (subject[g] < player[g]));
+        player[g] = changes ? subject[g] : player[g];
+        changed[g] |= changes;
+    }
+}
+
+[[gnu::noinline]] void transformLanes(Lane8* __restrict type, const Lane8* __restrict mask, const Lane8* __restrict subject, const Lane8* __restrict property) {
+    for(std::size_t g{}; g<LANES; ++g)
+        type[g] = mask[g] & (type[g] == subject[g]) ? property[g] : type[g];
+}
+
+[[gnu::noinline]] Lane8 ruleLanes(Lane8* __restrict mask, const Lane8* __restrict looping, const Lane8* __restrict changed, const std::uint16_t* __restrict ruleCount,
+                                  const Lane8* __restrict effects, std::size_t k, Lane8 effect) {
+    Lane8 result{};
+    for(std::size_t g{}; g<LANES; ++g) {
+        mask[g] = looping[g] & !changed[g] & (k < ruleCount[g]) & (effects[g] == effect);
+        result |= mask[g];
+    }
+    return result;
+}
+}
+
+BatchSimulation::BatchSimulation(const Simulation::State& start, std::size_t games)
+    : _games{games}, _blocks{(games+LANES-1)/LANES}, _rows{start.rows}, _cols{start.cols} {
+    const Simulation::State& initial{start.initial ? *start.initial : start};
+    _entities = std::max(start.entities.size(), initial.entities.size());
+
+    // Lanes past the last game stay dead and never match anything
+    const std::size_t cells{_blocks*_entities*LANES};
+    _row.resize(cells); _col.resize(cells); _dRow.resize(cells); _dCol.resize(cells);
+    _type.resize(cells); _alive.resize(cells);
+    _ruleSubject.resize(2*cells); _ruleProperty.resize(2*cells); // An IS text builds at most two sentences
+    _ruleCount.resize(_blocks*LANES);
+    _player.resize(_blocks*LANES); _gameOver.resize(_blocks*LANES); _reset.resize(_blocks*LANES);
+    _inputRow.resize(_blocks*LANES); _inputCol.resize(_blocks*LANES);
+    for(std::size_t g{}; g<_games; ++g) {
+        const std::size_t block{g/LANES}, lane{g%LANES};
+        for(std::size_t slot{}; slot<start.entities.size(); ++slot) {
+            const std::size_t i{(block*_entities + slot)*LANES + lane};
+            _row[i] = start.entities[slot].row;
+            _col[i] = start.entities[slot].col;
+            _type[i] = start.entities[slot].type;
+            _alive[i] = 1;
+        }
+        for(std::size_t k{}; k<start.rules.size(); ++k) {
+            _ruleSubject[(block*2*_entities + k)*LANES + lane] = start.rules[k].first;
+            _ruleProperty[(block*2*_entities + k)*LANES + lane] = start.rules[k].second;
+        }
+        _ruleCount[g] = static_cast<std::uint16_t>(start.rules.size());
+        _player[g] = start.player;
+        _gameOver[g] = start.gameOver;
+    }
+
+    _initialRow.resize(_entities); _initialCol.resize(_entities);
+    _initialType.resize(_entities); _initialAlive.resize(_entities);
+    for(std::size_t slot{}; slot<initial.entities.size(); ++slot) {
+        _initialRow[slot] = initial.entities[slot].row;
+        _initialCol[slot] = initial.entities[slot].col;
+        _initialType[slot] = initial.entities[slot].type;
+        _initialAlive[slot] = 1;
+    }
+
+    _mark.resize(_entities*LANES);
+    _moving.resize(_entities);
+    _words.reserve(_entities);
+    for(auto* lanes : {&_looping, &_changed, &_isText, &_mask, &_selected, &_subject, &_property, &_effect}) { lanes->resize(LANES); }
+    _foundRow.resize(LANES); _foundCol.resize(LANES); _found.resize(LANES);
+}
+
+void BatchSimulation::step(const std::vector<UserInput>& inputs) {
+    if(inputs.size() != _games) { throw std::invalid_argument{"BatchSimulation::step expects one input per game"}; }
+    const auto start{std::chrono::steady_clock::now()};
+
+    for(std::size_t g{}; g<_games; ++g) {
+        Direction direction{NODIR};
+        switch(inputs[g]) {
+            case UserInput::UP: direction = UP; break;
+            case UserInput::DOWN: direction = DOWN; break;
+            case UserInput::LEFT: direction = LEFT; break;
+            case UserInput::RIGHT: direction = RIGHT; break;
+            case UserInput::QUIT: _gameOver[g] = true; break;
+            default: break;
+        }
+        _inputRow[g] = direction.first;
+        _inputCol[g] = direction.second;
+        _reset[g] = inputs[g] == UserInput::RESET;
+    }
+
+    // Each block goes through the whole tick while its entities are in cache
+    for(_block = 0; _block<_blocks; ++_block) {
+        move();
+        std::fill_n(&_player[lanes()], LANES, NONE);
+        applyPermanentRules();
+        updateRules();
+        applyRules();
+    }
+
+    _stats.gameSteps += _games;
+    _stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+}
+
+Simulation::State BatchSimulation::state(std::size_t game) const {
+    if(game >= _games) { throw std::out_of_range{"BatchSimulation::state: no such game"}; }
+    const std::size_t block{game/LANES}, lane{game%LANES};
+    Simulation::State result{_rows, _cols, static_cast<EntityType>(_player[game]), static_cast<bool>(_gameOver[game]), {}, {}, nullptr};
+    for(std::size_t slot{}; slot<_entities; ++slot) {
+        const std::size_t i{(block*_entities + slot)*LANES + lane};
+        if(_alive[i])
+            result.entities.push_back({_row[i], _col[i], _type[i], static_cast<std::int8_t>(_dRow[i]), static_cast<std::int8_t>(_dCol[i]), 0});
+    }
+    for(std::size_t k{}; k<_ruleCount[game]; ++k) {
+        const std::size_t i{(block*2*_entities + k)*LANES + lane};
+        result.rules.emplace_back(static_cast<EntityType>(_ruleSubject[i]), static_cast<EntityType>(_ruleProperty[i]));
+    }
+    return result;
+}
+
+bool BatchSimulation::any(const std::vector<std::uint8_t>& lanes) {
+    std::uint8_t result{};
+    for(std::uint8_t lane : lanes) { result |= lane; }
+    return result;
+}
+
+bool BatchSimulation::selectSubjects(std::size_t slot) {
+    return selectLanes(_selected.data(), _mask.data(), &_alive[at(slot)], &_type[at(slot)], _subject.data());
+}
+
+void BatchSimulation::move() {
+    const std::uint8_t* reset{&_reset[lanes()]};
+    const bool resets{std::any_of(reset, reset+LANES, [](std::uint8_t r) { return r; })};
+    for(std::size_t slot{}; slot<_entities; ++slot) {
+        _moving[slot] = moveLanes(&_row[at(slot)], &_col[at(slot)], &_dRow[at(slot)], &_dCol[at(slot)], &_alive[at(slot)], &_type[at(slot)],
+                                  &_player[lanes()], &_inputRow[lanes()], &_inputCol[lanes()], _rows, _cols);
+        if(resets)
+            resetLanes(&_row[at(slot)], &_col[at(slot)], &_type[at(slot)], &_alive[at(slot)], reset,
+                       _initialRow[slot], _initialCol[slot], _initialType[slot], _initialAlive[slot]);
+    }
+}
+
+void BatchSimulation::applyPermanentRules() {
+    std::fill(_looping.begin(), _looping.end(), 1);
+    do {
+        std::fill(_changed.begin(), _changed.end(), 0);
+        for(EntityType text : RuleTable::permanentPush) {
+            for(std::size_t g{}; g<LANES; ++g) { _mask[g] = _looping[g] & !_changed[g]; }
+            std::fill(_subject.begin(), _subject.end(), text);
+            push();
+        }
+        _looping = _changed;
+    } while(any(_looping));
+}
+
+void BatchSimulation::updateRules() {
+    std::uint16_t* ruleCount{&_ruleCount[lanes()]};
+    std::fill_n(ruleCount, LANES, 0);
+    std::fill(_mask.begin(), _mask.end(), 1);
+
+    // Finds, in the selected games, the first entity at an offset of an IS text with an entry in a table
+    auto findText{[this](std::size_t is, int dRow, int dCol, const std::array<EntityType, RuleTable::TYPE_COUNT>& table, std::vector<std::uint8_t>& found) {
+        std::fill(found.begin(), found.end(), NONE);
+        for(std::size_t slot : _words)
+            findTextLanes(found.data(), _selected.data(), &_row[at(is)], &_col[at(is)], dRow, dCol, &_row[at(slot)], &_col[at(slot)], &_type[at(slot)], &_alive[at(slot)], table.data());
+    }};
+    auto addSentences{[this, ruleCount]() {
+        for(std::size_t g{}; g<LANES; ++g)
+            if(_selected[g] && _subject[g] != NONE && _property[g] != NONE) {
+                const std::size_t k{ruleCount[g]++};
+                _ruleSubject[rule(k) + g] = _subject[g];
+                _ruleProperty[rule(k) + g] = _property[g];
+            }
+    }};
+
+    // Only the texts can be found next to an IS
+    _words.clear();
+    for(std::size_t slot{}; slot<_entities; ++slot)
+        if(wordLanes(&_type[at(slot)], &_alive[at(slot)], RuleTable::propertyOf.data())) { _words.push_back(slot); }
+
+    for(std::size_t is : _words) {
+        std::fill(_subject.begin(), _subject.end(), IS);
+        if(!selectSubjects(is)) { continue; }
+        // findText overwrites _subject, so the IS selection is kept aside
+        _isText = _selected;
+        findText(is, 0, -1, RuleTable::subjectOf, _subject);
+        for(std::size_t g{}; g<LANES; ++g) { _selected[g] = _isText[g] & (_subject[g] != NONE); }
+        findText(is, 0, 1, RuleTable::propertyOf, _property);
+        addSentences();
+
+        _selected = _isText;
+        findText(is, -1, 0, RuleTable::subjectOf, _subject);
+        for(std::size_t g{}; g<LANES; ++g) { _selected[g] = _isText[g] & (_subject[g] != NONE); }
+        findText(is, 1, 0, RuleTable::propertyOf, _property);
+        addSentences();
+    }
+}
+
+void BatchSimulation::applyRules() {
+    const std::uint16_t* ruleCount{&_ruleCount[lanes()]};
+    std::fill(_looping.begin(), _looping.end(), 1);
+    do {
+        std::fill(_changed.begin(), _changed.end(), 0);
+        std::uint16_t slots{};
+        for(std::size_t g{}; g<LANES; ++g) { slots = std::max(slots, _looping[g] ? ruleCount[g] : std::uint16_t{}); }
+        for(std::size_t k{}; k<slots; ++k) {
+            const std::uint8_t* property{&_ruleProperty[rule(k)]};
+            std::copy_n(&_ruleSubject[rule(k)], LANES, _subject.begin());
+            std::copy_n(property, LANES, _property.begin());
+            for(std::size_t g{}; g<LANES; ++g)
+                _effect[g] = static_cast<std::uint8_t>(k < ruleCount[g] ? RuleTable::effectOf[property[g]] : RuleTable::Effect::TRANSFORM);
+
+            // Every game applies one sentence per slot, so the effects are dispatched under disjoint masks
+            auto run{[&](RuleTable::Effect effect, void (BatchSimulation::*apply)()) {
+                if(ruleLanes(_mask.data(), _looping.data(), _changed.data(), ruleCount, _effect.data(), k, static_cast<Lane8>(effect))) { (this->*apply)(); }
+            }};
+            run(RuleTable::Effect::YOU, &BatchSimulation::you);
+            run(RuleTable::Effect::STOP, &BatchSimulation::stop);
+            run(RuleTable::Effect::PUSH, &BatchSimulation::push);
+            run(RuleTable::Effect::WIN, &BatchSimulation::win);
+            run(RuleTable::Effect::KILL, &BatchSimulation::kill);
+            run(RuleTable::Effect::SINK, &BatchSimulation::sink);
+            run(RuleTable::Effect::TRANSFORM, &BatchSimulation::transform);
+        }
+        _looping = _changed;
+    } while(any(_looping));
+}
+
+void BatchSimulation::push() {
+    for(std::size_t slot{}; slot<_entities; ++slot) {
+        if(!selectSubjects(slot)) { continue; }
+        std::fill(_found.begin(), _found.end(), -1);
+        for(std::size_t other{}; other<_entities; ++other)
+            if(other != slot && _moving[other])
+                findPusherLanes(_found.data(), _foundRow.data(), _foundCol.data(), _selected.data(), &_row[at(slot)], &_col[at(slot)],
+                                &_row[at(other)], &_col[at(other)], &_dRow[at(other)], &_dCol[at(other)], &_alive[at(other)], static_cast<std::int32_t>(other));
+        _moving[slot] |= pushAlongLanes(&_row[at(slot)], &_col[at(slot)], &_dRow[at(slot)], &_dCol[at(slot)], _found.data(), _foundRow.data(), _foundCol.data(), _changed.data(), _rows, _cols);
+
+        // The pushers which could not move the entity bounce back
+        for(std::size_t other{}; other<_entities; ++other)
+            if(_moving[other] && pushersLanes(_isText.data(), _found.data(), static_cast<std::int32_t>(other)))
+                bounceLanes(&_row[at(other)], &_col[at(other)], &_dRow[at(other)], &_dCol[at(other)], _isText.data());
+    }
+}
+
+void BatchSimulation::stop() {
+    // Stop entities never move here, so their positions can be read while moving the others
+    for(std::size_t slot{}; slot<_entities; ++slot) {
+        if(!selectSubjects(slot)) { continue; }
+        for(std::size_t other{}; other<_entities; ++other)
+            if(other != slot && _moving[other] && sharedCellLanes(_isText.data(), _selected.data(), _subject.data(), &_row[at(slot)], &_col[at(slot)],
+                                                                  &_row[at(other)], &_col[at(other)], &_type[at(other)], &_alive[at(other)]))
+                bounceLanes(&_row[at(other)], &_col[at(other)], &_dRow[at(other)], &_dCol[at(other)], _isText.data());
+    }
+}
+
+void BatchSimulation::win() {
+    // selectSubjects picks the entities of YOU, the subjects of the sentences are kept aside meanwhile
+    _isText = _subject;
+    std::copy_n(&_player[lanes()], LANES, _subject.begin());
+    for(std::size_t slot{}; slot<_entities; ++slot) {
+        if(!selectSubjects(slot)) { continue; }
+        for(std::size_t other{}; other<_entities; ++other)
+            winLanes(&_gameOver[lanes()], _selected.data(), _isText.data(), &_row[at(slot)], &_col[at(slot)], &_row[at(other)], &_col[at(other)], &_type[at(other)], &_alive[at(other)]);
+    }
+    _subject = _isText;
+}
+
+void BatchSimulation::kill() {
+    // Killers are never killed, so victims can be removed right away
+    for(std::size_t slot{}; slot<_entities; ++slot) {
+        if(!selectSubjects(slot)) { continue; }
+        for(std::size_t other{}; other<_entities; ++other)
+            if(other != slot && sharedCellLanes(_isText.data(), _selected.data(), _subject.data(), &_row[at(slot)], &_col[at(slot)],
+                                                &_row[at(other)], &_col[at(other)], &_type[at(other)], &_alive[at(other)]))
+                clearLanes(&_alive[at(other)], _isText.data(), LANES);
+    }
+}
+
+void BatchSimulation::sink() {
+    // A sunk entity still sinks the other entities of its cell, so removals wait for every sink
+    std::fill(_mark.begin(), _mark.end(), 0);
+    for(std::size_t slot{}; slot<_entities; ++slot) {
+        if(!selectSubjects(slot)) { continue; }
+        for(std::size_t other{}; other<_entities; ++other)
+            if(other != slot && sharedCellLanes(_isText.data(), _selected.data(), _subject.data(), &_row[at(slot)], &_col[at(slot)],
+                                                &_row[at(other)], &_col[at(other)], &_type[at(other)], &_alive[at(other)])) {
+                orLanes(&_mark[other*LANES], _isText.data());
+                orLanes(&_mark[slot*LANES], _isText.data());
+            }
+    }
+    clearLanes(_alive.data() + at(0), _mark.data(), _mark.size());
+}
+
+void BatchSimulation::you() {
+    youLanes(&_player[lanes()], _changed.data(), _mask.data(), _subject.data());
+}
+
+void BatchSimulation::transform() {
+    for(std::size_t slot{}; slot<_entities; ++slot)
+        transformLanes(&_type[at(slot)], _mask.data(), _subject.data(), _property.data());
+}
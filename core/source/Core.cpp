@@ -9,26 +9,65 @@ void Core::movePlayer(Direction direction) {
     });
 }
 
-void Core::resetMap() { _map = _initialMap; }
-
-Core::Core(const std::string& filePath) : _gameOver{}, _map{LevelLoader::loadLevel(filePath)}, _initialMap{_map}, _playerEntity{NONE}, _allRules{getAllRules()}, _rules{}, _permanentRules {
-    std::make_shared<IsPush>(TEXT_BABA),
-    std::make_shared<IsPush>(TEXT_FLAG),
-    std::make_shared<IsPush>(TEXT_GRASS),
-    std::make_shared<IsPush>(TEXT_LAVA),
-    std::make_shared<IsPush>(TEXT_METAL),
-    std::make_shared<IsPush>(TEXT_ROCK),
-    std::make_shared<IsPush>(TEXT_WATER),
-    std::make_shared<IsPush>(TEXT_WALL),
-    std::make_shared<IsPush>(YOU),
-    std::make_shared<IsPush>(STOP),
-    std::make_shared<IsPush>(PUSH),
-    std::make_shared<IsPush>(WIN),
-    std::make_shared<IsPush>(KILL),
-    std::make_shared<IsPush>(SINK),
-    std::make_shared<IsPush>(IS),
-    std::make_shared<IsPush>(BEST),
-} {}
+void Core::resetMap() {
+    _tick.replaced = true;
+    _tick.entitiesBefore = std::move(_map.entities);
+    _initialMap.restore(_map, this);
+    replacedEntities();
+    _tick.entitiesAfter = _map.entities;
+}
+
+void Core::attachEntities() {
+    for(MapEntity& entity : _map.entities)
+        entity.setListener(this);
+}
+
+void Core::replacedEntities() {
+    _dirtyChunks.markAll();
+    _entitiesHash = Zobrist::hash(_map.entities);
+}
+
+CoreState Core::loadState(const std::string& filePath) {
+    if(BinarySnapshot::isSnapshot(filePath))
+        return BinarySnapshot::load(filePath);
+    Map map{LevelLoader::loadLevel(filePath)};
+    std::vector<PackedEntity> entities{CoreState::pack(map.entities)};
+    return CoreState{map.levelName, map.size, entities, entities, NONE, false, {}};
+}
+
+Core::Core(const std::string& filePath) : Core{loadState(filePath)} {}
+
+Core::Core(const CoreState& state) : _map{}, _initialMap{}, _allRules{getAllRules()}, _permanentRules{getPermanentRules()}, _rules{std::make_shared<CompiledRules>()}, _ruleCache{}, _playerEntity{state.playerEntity}, _gameOver{state.gameOver}, _journal{}, _tick{}, _lastStep{}, _recording{}, _snapshot{}, _dirtyChunks{}, _entitiesHash{} {
+    _map.levelName = state.levelName;
+    _map.size = state.size;
+    CoreState::unpack(_map, state.initialEntities);
+    _initialMap = MapSnapshot{_map};
+    CoreState::unpack(_map, state.entities);
+    attachEntities();
+    replacedEntities();
+    if(!state.rules.empty()) {
+        _rules = _ruleCache.get(state.rules, [this](const std::vector<Sentence>& sentences) {
+            return compileRules(sentences);
+        });
+    }
+}
+
+Core::Core(const std::string& filePath, const std::string& journalDirectory, unsigned snapshotInterval) : Core{filePath} {
+    std::unique_ptr<SessionJournal> session;
+    // A journal which can't be written only loses the crash recovery, not the game
+    try { session = std::make_unique<SessionJournal>(journalDirectory, filePath, snapshotInterval); }
+    catch(const std::filesystem::filesystem_error&) { update(); return; }
+    SessionJournal::Recovery recovery{session->recover()};
+    if(recovery.snapshot) { restore(*recovery.snapshot); }
+    else { update(); }
+    for(UserInput input : recovery.inputs) {
+        manageInput(input);
+        update();
+    }
+    // Compacts the recovered session into a fresh snapshot before accepting new inputs
+    session->writeSnapshot(snapshot());
+    _session = std::move(session);
+}
 
 const Map& Core::getMap() const {
     return _map;
@@ -38,59 +77,235 @@ bool Core::isGameOver() const {
     return _gameOver;
 }
 
+const CompiledRules& Core::getActiveRules() const {
+    return *_rules;
+}
+
+const RuleCacheStats& Core::getRuleCacheStats() const {
+    return _ruleCache.getStats();
+}
+
+const DeltaJournal& Core::getJournal() const {
+    return _journal;
+}
+
+const TickStep& Core::getLastStep() const {
+    return _lastStep;
+}
+
+void Core::beginTick() {
+    _recording = true;
+    _tick.gameOverBefore = _gameOver;
+}
+
+void Core::commitTick() {
+    if(!_recording) { return; }
+    _recording = false;
+    _tick.gameOverAfter = _gameOver;
+    if(_settling) {
+        // The rules changed the map right after an undo or a redo
+        _settling = false;
+        if(!_tick.empty()) {
+            _lastStep.settled = std::make_shared<const MapDelta>(std::move(_tick));
+            _journal.amend(*_lastStep.settled);
+        }
+    }
+    else if(!_tick.empty()) {
+        _lastStep = {std::make_shared<const MapDelta>(std::move(_tick)), false};
+        _journal.push(_lastStep.delta);
+    }
+    _tick = MapDelta{};
+}
+
+void Core::journalInput(UserInput input) {
+    if(!_session) { return; }
+    switch(input) {
+        case UserInput::UP: case UserInput::DOWN: case UserInput::LEFT: case UserInput::RIGHT: case UserInput::RESET:
+            _session->append(input); break;
+        // The undo history is not journalled, so undo and redo are checkpointed by a snapshot
+        case UserInput::UNDO: case UserInput::REDO:
+            _session->requestSnapshot(); break;
+        default:
+            break;
+    }
+}
+
+void Core::undo() {
+    commitTick();
+    if(auto delta{_journal.undo()}) {
+        delta->undo(_map, this);
+        if(delta->replaced) { replacedEntities(); }
+        _gameOver = delta->gameOverBefore;
+        _lastStep = {delta, true};
+        // Records what the rules change in the update that follows
+        beginTick();
+        _settling = true;
+    }
+}
+
+void Core::redo() {
+    commitTick();
+    if(auto delta{_journal.redo()}) {
+        delta->redo(_map, this);
+        if(delta->replaced) { replacedEntities(); }
+        _gameOver = delta->gameOverAfter;
+        _lastStep = {delta, false};
+        // Records what the rules change in the update that follows
+        beginTick();
+        _settling = true;
+    }
+}
+
+MapSnapshot Core::snapshot() const {
+    if(!_dirtyChunks.empty()) {
+        _snapshot = _snapshot.update(_map, _dirtyChunks);
+        _dirtyChunks.clear();
+    }
+    return _snapshot;
+}
+
+CoreState Core::getState() const {
+    return CoreState{_map.levelName, _map.size, CoreState::pack(_map.entities), CoreState::pack(_initialMap), _playerEntity, _gameOver, _rules->sentences};
+}
+
+void Core::flushSaves() {
+    _saver.flush();
+    if(_session) { _session->flush(); }
+}
+
+bool Core::isJournaling() const {
+    return _session != nullptr;
+}
+
+std::size_t Core::failedSaves() const {
+    return _saver.failures();
+}
+
+std::string Core::lastSaveError() const {
+    return _saver.lastError();
+}
+
+void Core::setSaveDirectory(const std::string& directory) {
+    _saveDirectory = directory;
+}
+
+void Core::restore(const MapSnapshot& snapshot) {
+    commitTick();
+    _journal.clear();
+    snapshot.restore(_map, this);
+    replacedEntities();
+    _snapshot = snapshot;
+    _dirtyChunks.clear();
+    _lastStep = {};
+    _gameOver = false;
+    refreshRules();
+}
+
+std::uint64_t Core::stateHash() const {
+    return _entitiesHash + Zobrist::playerKey(_playerEntity);
+}
+
+void Core::entityMoved(const MapEntity& entity, Position from) {
+    _dirtyChunks.markEntity(&entity - _map.entities.data());
+    _entitiesHash += Zobrist::key(entity.getType(), entity.getPosition()) - Zobrist::key(entity.getType(), from);
+    if(_recording)
+        _tick.recordMove(&entity - _map.entities.data(), entity.getType(), from, entity.getPosition());
+}
+
+void Core::entityTypeChanged(const MapEntity& entity, EntityType oldType) {
+    _dirtyChunks.markEntity(&entity - _map.entities.data());
+    _entitiesHash += Zobrist::key(entity.getType(), entity.getPosition()) - Zobrist::key(oldType, entity.getPosition());
+    if(_recording)
+        _tick.recordType(&entity - _map.entities.data(), oldType, entity.getType(), entity.getPosition());
+}
+
+void Core::entityRemoved(const MapEntity& entity) {
+    _dirtyChunks.markShift(&entity - _map.entities.data());
+    _entitiesHash -= Zobrist::key(entity.getType(), entity.getPosition());
+    if(_recording)
+        _tick.recordRemoval(&entity - _map.entities.data(), entity.getType(), entity.getPosition());
+}
+
+void Core::entityAdded(const MapEntity& entity) {
+    _dirtyChunks.markShift(&entity - _map.entities.data());
+    _entitiesHash += Zobrist::key(entity.getType(), entity.getPosition());
+}
+
 void Core::resetEntities() {
     for(MapEntity& entity : _map.entities)
         entity.resetDirection();
 }
 void Core::updateRules() {
-    std::vector<std::pair<EntityType, EntityType>> rulesOnMap{};
+    std::vector<Sentence> rulesOnMap{};
     for(const auto& is : _map.entities) {
         if(is.getType() != IS) { continue; }
 
         auto entBuffer = std::find_if(std::begin(_map.entities), std::end(_map.entities), [&](const MapEntity& entity) {
-            return entity.getPosition() == is.getPosition()+LEFT && textEntToRealEnt.contains(entity.getType());
+            return entity.getPosition() == is.getPosition()+LEFT && RuleTable::subjectOf[entity.getType()] != NONE;
         });
         if(entBuffer != std::end(_map.entities)) {
-            EntityType subjectType = textEntToRealEnt.at(entBuffer->getType());
+            EntityType subjectType = RuleTable::subjectOf[entBuffer->getType()];
             entBuffer = std::find_if(std::begin(_map.entities), std::end(_map.entities), [&](const MapEntity& entity) {
-                return entity.getPosition() == is.getPosition()+RIGHT && textEntToRule.contains(entity.getType());
+                return entity.getPosition() == is.getPosition()+RIGHT && RuleTable::propertyOf[entity.getType()] != NONE;
             });
             if(entBuffer != std::end(_map.entities))
-                rulesOnMap.push_back({subjectType, textEntToRule.at(entBuffer->getType())});
+                rulesOnMap.push_back({subjectType, RuleTable::propertyOf[entBuffer->getType()]});
         }
         entBuffer = std::find_if(std::begin(_map.entities), std::end(_map.entities), [&](const MapEntity& entity) {
-            return entity.getPosition() == is.getPosition()+UP && textEntToRealEnt.contains(entity.getType());
+            return entity.getPosition() == is.getPosition()+UP && RuleTable::subjectOf[entity.getType()] != NONE;
         });
         if(entBuffer != std::end(_map.entities)) {
-            EntityType subjectType = textEntToRealEnt.at(entBuffer->getType());
+            EntityType subjectType = RuleTable::subjectOf[entBuffer->getType()];
             entBuffer = std::find_if(std::begin(_map.entities), std::end(_map.entities), [&](const MapEntity& entity) {
-                return entity.getPosition() == is.getPosition()+DOWN && textEntToRule.contains(entity.getType());
+                return entity.getPosition() == is.getPosition()+DOWN && RuleTable::propertyOf[entity.getType()] != NONE;
             });
             if(entBuffer != std::end(_map.entities))
-                rulesOnMap.push_back({subjectType, textEntToRule.at(entBuffer->getType())});
+                rulesOnMap.push_back({subjectType, RuleTable::propertyOf[entBuffer->getType()]});
         }
     }
 
-    _rules.clear();
-    for(const auto& rule : rulesOnMap)
-        _rules.push_back(_allRules.at(rule));
+    _rules = _ruleCache.get(rulesOnMap, [this](const std::vector<Sentence>& sentences) {
+        return compileRules(sentences);
+    });
+}
+
+CompiledRules Core::compileRules(const std::vector<Sentence>& sentences) const {
+    CompiledRules result{sentences, {}, {}, {}, {}};
+    for(const auto& sentence : sentences) {
+        const auto& [subject, property] = sentence;
+        result.rules.push_back(_allRules.at(sentence));
+        switch(RuleTable::effectOf[property]) {
+            case RuleTable::Effect::YOU: result.you.insert(subject); [[fallthrough]];
+            case RuleTable::Effect::STOP: case RuleTable::Effect::PUSH: case RuleTable::Effect::WIN: case RuleTable::Effect::KILL: case RuleTable::Effect::SINK:
+                result.properties[subject].insert(property); break;
+            case RuleTable::Effect::TRANSFORM:
+                result.transforms.insert({subject, property}); break;
+        }
+    }
+    return result;
 }
 
 void Core::manageInput(UserInput input) {
+    _lastStep = {};
+    journalInput(input);
     resetEntities();
     switch(input) {
         case UserInput::UP:
-            movePlayer(UP); break;
+            beginTick(); movePlayer(UP); break;
         case UserInput::DOWN:
-            movePlayer(DOWN); break;
+            beginTick(); movePlayer(DOWN); break;
         case UserInput::LEFT:
-            movePlayer(LEFT); break;
+            beginTick(); movePlayer(LEFT); break;
         case UserInput::RIGHT:
-            movePlayer(RIGHT); break;
+            beginTick(); movePlayer(RIGHT); break;
         case UserInput::RESET:
-            resetMap(); break;
+            commitTick(); beginTick(); resetMap(); break;
+        case UserInput::UNDO:
+            undo(); break;
+        case UserInput::REDO:
+            redo(); break;
         case UserInput::SAVE:
-            LevelLoader::saveLevel(_map); break;
+            _saver.save({snapshot(), _initialMap, _playerEntity, _gameOver, _rules->sentences, _saveDirectory}); break;
         case UserInput::QUIT:
             _gameOver = true; break;
         default:
@@ -110,7 +325,7 @@ void Core::applyRules() {
     bool changed{};
     do {
         changed = false;
-        for(auto& rule : _rules)
+        for(auto& rule : _rules->rules)
             changed = changed || rule->apply(_map.entities);
     } while(changed);
 }
@@ -119,26 +334,55 @@ void Core::applyRules() {
 std::map<std::pair<EntityType, EntityType>, std::shared_ptr<Rule>> Core::getAllRules() {
     std::map<std::pair<EntityType, EntityType>, std::shared_ptr<Rule>> result{};
     std::shared_ptr<Rule> ruleBuffer;
-    for(const auto& [_, ent] : textEntToRealEnt)
-        for(const auto& [_, rule] : textEntToRule) {
-            switch(rule) {
-                case YOU: ruleBuffer = std::make_unique<IsYou>(ent, &_playerEntity); break;
-                case STOP: ruleBuffer = std::make_unique<IsStop>(ent); break;
-                case PUSH: ruleBuffer = std::make_unique<IsPush>(ent); break;
-                case WIN: ruleBuffer = std::make_unique<IsWin>(ent, &_playerEntity, &_gameOver); break;
-                case KILL: ruleBuffer = std::make_unique<IsKill>(ent); break;
-                case SINK: ruleBuffer = std::make_unique<IsSink>(ent); break;
-                default: ruleBuffer = std::make_unique<EntityIsEntity>(ent, rule); break;
+    for(EntityType ent : RuleTable::subjectOf)
+        for(EntityType rule : RuleTable::propertyOf) {
+            if(ent == NONE || rule == NONE) { continue; }
+            switch(RuleTable::effectOf[rule]) {
+                case RuleTable::Effect::YOU: ruleBuffer = std::make_unique<IsYou>(ent, &_playerEntity); break;
+                case RuleTable::Effect::STOP: ruleBuffer = std::make_unique<IsStop>(ent); break;
+                case RuleTable::Effect::PUSH: ruleBuffer = std::make_unique<IsPush>(ent); break;
+                case RuleTable::Effect::WIN: ruleBuffer = std::make_unique<IsWin>(ent, &_playerEntity, &_gameOver); break;
+                case RuleTable::Effect::KILL: ruleBuffer = std::make_unique<IsKill>(ent); break;
+                case RuleTable::Effect::SINK: ruleBuffer = std::make_unique<IsSink>(ent); break;
+                case RuleTable::Effect::TRANSFORM: ruleBuffer = std::make_unique<EntityIsEntity>(ent, rule); break;
             }
             result.insert({{ent, rule}, ruleBuffer});
         }
     return result;
 }
 
-void Core::update() {
+// Builds the rules pushing the texts, applied before the sentences are read
+std::vector<std::shared_ptr<Rule>> Core::getPermanentRules() {
+    std::vector<std::shared_ptr<Rule>> result;
+    for(EntityType text : RuleTable::permanentPush)
+        result.push_back(std::make_shared<IsPush>(text));
+    return result;
+}
+
+void Core::refreshRules() {
     _playerEntity = NONE;
     applyPermanentRules();
     updateRules();
     applyRules();
+}
+
+void Core::update() {
+    refreshRules();
+    commitTick();
+    if(_session) {
+        if(_gameOver || _session->failed()) {
+            if(_gameOver) { _session->discard(); }
+            _session.reset();
+        }
+        else if(_session->snapshotDue()) { _session->writeSnapshot(snapshot()); }
+    }
+    if(!_notificationsSuspended) { notifyObservers(); }
+}
+
+void Core::setNotificationsSuspended(bool suspended) {
+    _notificationsSuspended = suspended;
+}
+
+void Core::refreshObservers() const {
     notifyObservers();
 }
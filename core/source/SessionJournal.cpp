@@ -0,0 +1,151 @@
+#include "../SessionJournal.h"
+#include <sstream>
+#include <stdexcept>
+
+std::filesystem::path SessionJournal::logPath() const { return _directory / "session.log"; }
+std::filesystem::path SessionJournal::snapshotPath() const { return _directory / "session.snapshot"; }
+
+SessionJournal::SessionJournal(const std::string& directory, const std::string& levelPath, unsigned snapshotInterval)
+    : _directory{directory}, _levelPath{levelPath}, _snapshotInterval{snapshotInterval ? snapshotInterval : 1}, _sinceSnapshot{}, _generation{}, _log{} {
+    std::filesystem::create_directories(_directory);
+}
+
+SessionJournal::~SessionJournal() {
+    if(!_writer.joinable()) { return; }
+    {
+        std::lock_guard lock{_mutex};
+        _stopping = true;
+    }
+    _queued.notify_one();
+    _writer.join();
+}
+
+// Reads a "<generation> <level path>" header, returns false if it belongs to another level
+static bool readHeader(std::istream& file, const std::string& levelPath, unsigned long& generation) {
+    std::string header;
+    if(!std::getline(file, header)) { return false; }
+    std::stringstream strm(header);
+    std::string path;
+    if(!(strm >> generation) || !std::getline(strm >> std::ws, path)) { return false; }
+    return path == levelPath;
+}
+
+SessionJournal::Recovery SessionJournal::recover() {
+    Recovery result{};
+    unsigned long snapshotGeneration{}, logGeneration{};
+
+    std::ifstream snapshot{snapshotPath()};
+    if(snapshot && readHeader(snapshot, _levelPath, snapshotGeneration)) {
+        Map map{LevelLoader::parseLevel(snapshot, _levelPath)};
+        result.snapshot = MapSnapshot{map};
+        _generation = snapshotGeneration;
+    }
+
+    // A log is only valid on top of the snapshot written right before it
+    std::ifstream log{logPath()};
+    if(!log || !readHeader(log, _levelPath, logGeneration) || logGeneration != _generation)
+        return result;
+    char c;
+    while(log.get(c))
+        if(charToInput(c) != UserInput::NONE)
+            result.inputs.push_back(charToInput(c));
+    return result;
+}
+
+void SessionJournal::openLog() {
+    _log.close();
+    _log.open(logPath(), std::ios::trunc);
+    _log << _generation << ' ' << _levelPath << '\n';
+    _log.flush();
+}
+
+void SessionJournal::queue(Write write) {
+    if(_failed) { return; }
+    {
+        std::lock_guard lock{_mutex};
+        _writes.push_back(std::move(write));
+        if(!_writer.joinable()) { _writer = std::thread{&SessionJournal::run, this}; }
+    }
+    _queued.notify_one();
+}
+
+void SessionJournal::run() {
+    std::unique_lock lock{_mutex};
+    while(true) {
+        _queued.wait(lock, [this] { return _stopping || !_writes.empty(); });
+        if(_writes.empty()) { return; }
+
+        Write write{std::move(_writes.front())};
+        _writes.pop_front();
+        _writing = true;
+        lock.unlock();
+        // A journal which can't be written must not take the game down
+        try { perform(write); }
+        catch(const std::exception&) { _failed = true; }
+        lock.lock();
+        if(_failed) { _writes.clear(); }
+        _writing = false;
+        _written.notify_all();
+    }
+}
+
+void SessionJournal::perform(const Write& write) {
+    switch(write.kind) {
+        case Write::INPUT:
+            if(!_log.is_open()) { openLog(); }
+            _log.put(inputToChar(write.input));
+            _log.flush();
+            break;
+        case Write::SNAPSHOT: {
+            const std::filesystem::path temporary{_directory / "session.snapshot.tmp"};
+            {
+                Map map;
+                write.map.restore(map);
+                std::ofstream outfile{temporary, std::ios::trunc};
+                outfile << _generation+1 << ' ' << _levelPath << '\n';
+                LevelLoader::writeLevel(outfile, map);
+                if(!outfile) { throw std::runtime_error{"Could not write " + temporary.string()}; }
+            }
+            std::filesystem::rename(temporary, snapshotPath());
+            ++_generation;
+            openLog();
+            break;
+        }
+        case Write::DISCARD:
+            _log.close();
+            std::filesystem::remove(logPath());
+            std::filesystem::remove(snapshotPath());
+            break;
+    }
+}
+
+void SessionJournal::append(UserInput input) {
+    queue({Write::INPUT, input});
+    ++_sinceSnapshot;
+}
+
+bool SessionJournal::snapshotDue() const {
+    return _sinceSnapshot >= _snapshotInterval;
+}
+
+void SessionJournal::requestSnapshot() {
+    _sinceSnapshot = _snapshotInterval;
+}
+
+void SessionJournal::writeSnapshot(MapSnapshot map) {
+    queue({Write::SNAPSHOT, UserInput::NONE, std::move(map)});
+    _sinceSnapshot = 0;
+}
+
+void SessionJournal::discard() {
+    queue({Write::DISCARD});
+}
+
+void SessionJournal::flush() {
+    std::unique_lock lock{_mutex};
+    _written.wait(lock, [this] { return _writes.empty() && !_writing; });
+}
+
+bool SessionJournal::failed() const {
+    return _failed;
+}
@@ -0,0 +1,233 @@
+#include "../Simulation.h"
+#include "../Zobrist.h"
+
+namespace Simulation {
+namespace {
+constexpr std::uint8_t REMOVED{1};
+
+bool samePosition(const Entity& lhs, const Entity& rhs) { return lhs.row == rhs.row && lhs.col == rhs.col; }
+
+bool canMove(const State& state, const Entity& entity, int dRow, int dCol) {
+    const int row{entity.row + dRow}, col{entity.col + dCol};
+    return row >= 0 && col >= 0 && row < state.rows && col < state.cols;
+}
+
+void move(Entity& entity, int dRow, int dCol) {
+    entity.dRow = dRow; entity.dCol = dCol;
+    entity.row += dRow; entity.col += dCol;
+}
+
+void movePlayer(State& state, int dRow, int dCol) {
+    for(Entity& entity : state.entities)
+        if(entity.type == state.player && canMove(state, entity, dRow, dCol))
+            move(entity, dRow, dCol);
+}
+
+// Erases the entities flagged as removed, keeping the order of the others
+void eraseRemoved(State& state) {
+    std::size_t kept{};
+    for(std::size_t i{}; i<state.entities.size(); ++i)
+        if(!(state.entities[i].flags & REMOVED))
+            state.entities[kept++] = state.entities[i];
+    state.entities.resize(kept);
+}
+
+// Rules.h counterparts, applied in the same order over the same entities
+bool isPush(State& state, EntityType subject) {
+    bool changed{};
+    auto& map{state.entities};
+    for(Entity& entity : map) {
+        if(entity.type != subject) { continue; }
+        Entity* found{};
+        for(Entity& ent : map)
+            if(samePosition(entity, ent) && &entity != &ent && (ent.dRow || ent.dCol)) { found = &ent; break; }
+        if(!found) { continue; }
+        if(canMove(state, entity, found->dRow, found->dCol) && !entity.dRow && !entity.dCol) {
+            move(entity, found->dRow, found->dCol);
+            changed = true;
+        }
+        else
+            move(*found, -found->dRow, -found->dCol);
+    }
+    return changed;
+}
+
+bool isStop(State& state, EntityType subject) {
+    // Stop entities never move here, so their positions can be read while moving the others
+    for(const Entity& stop : state.entities) {
+        if(stop.type != subject) { continue; }
+        for(Entity& ent : state.entities)
+            if(samePosition(ent, stop) && ent.type != subject)
+                move(ent, -ent.dRow, -ent.dCol);
+    }
+    return false;
+}
+
+bool isKill(State& state, EntityType subject) {
+    bool any{};
+    for(Entity& ent : state.entities) {
+        ent.flags &= ~REMOVED;
+        if(ent.type == subject) { continue; }
+        for(const Entity& killer : state.entities)
+            if(killer.type == subject && samePosition(ent, killer)) { ent.flags |= REMOVED; any = true; break; }
+    }
+    if(any) { eraseRemoved(state); }
+    return false;
+}
+
+bool isSink(State& state, EntityType subject) {
+    bool any{};
+    for(Entity& ent : state.entities) { ent.flags &= ~REMOVED; }
+    for(Entity& sink : state.entities) {
+        if(sink.type != subject) { continue; }
+        for(Entity& ent : state.entities)
+            if(samePosition(ent, sink) && ent.type != subject) {
+                ent.flags |= REMOVED;
+                sink.flags |= REMOVED;
+                any = true;
+            }
+    }
+    if(any) { eraseRemoved(state); }
+    return false;
+}
+
+bool isWin(State& state, EntityType subject) {
+    for(const Entity& player : state.entities) {
+        if(player.type != state.player) { continue; }
+        for(const Entity& ent : state.entities)
+            if(ent.type == subject && samePosition(ent, player)) { state.gameOver = true; break; }
+    }
+    return false;
+}
+
+bool isYou(State& state, EntityType subject) {
+    if(state.player <= subject) { return false; }
+    state.player = subject;
+    return true;
+}
+
+bool entityIsEntity(State& state, EntityType subject, EntityType newEntity) {
+    for(Entity& ent : state.entities)
+        if(ent.type == subject) { ent.type = newEntity; }
+    return false;
+}
+
+bool apply(State& state, const Sentence& sentence) {
+    const auto [subject, property] = sentence;
+    switch(RuleTable::effectOf[property]) {
+        case RuleTable::Effect::YOU: return isYou(state, subject);
+        case RuleTable::Effect::STOP: return isStop(state, subject);
+        case RuleTable::Effect::PUSH: return isPush(state, subject);
+        case RuleTable::Effect::WIN: return isWin(state, subject);
+        case RuleTable::Effect::KILL: return isKill(state, subject);
+        case RuleTable::Effect::SINK: return isSink(state, subject);
+        case RuleTable::Effect::TRANSFORM: break;
+    }
+    return entityIsEntity(state, subject, property);
+}
+
+void applyPermanentRules(State& state) {
+    bool changed{};
+    do {
+        changed = false;
+        for(EntityType text : RuleTable::permanentPush)
+            changed = changed || isPush(state, text);
+    } while(changed);
+}
+
+// Finds the first entity on a cell whose type has an entry in a lookup table
+EntityType findText(const State& state, int row, int col, const std::array<EntityType, RuleTable::TYPE_COUNT>& table) {
+    for(const Entity& ent : state.entities)
+        if(ent.row == row && ent.col == col && table[ent.type] != NONE)
+            return table[ent.type];
+    return NONE;
+}
+
+void updateRules(State& state) {
+    state.rules.clear();
+    for(const Entity& is : state.entities) {
+        if(is.type != IS) { continue; }
+        EntityType subject{findText(state, is.row, is.col-1, RuleTable::subjectOf)};
+        if(subject != NONE) {
+            EntityType property{findText(state, is.row, is.col+1, RuleTable::propertyOf)};
+            if(property != NONE) { state.rules.push_back({subject, property}); }
+        }
+        subject = findText(state, is.row-1, is.col, RuleTable::subjectOf);
+        if(subject != NONE) {
+            EntityType property{findText(state, is.row+1, is.col, RuleTable::propertyOf)};
+            if(property != NONE) { state.rules.push_back({subject, property}); }
+        }
+    }
+}
+
+void applyRules(State& state) {
+    bool changed{};
+    do {
+        changed = false;
+        for(const Sentence& sentence : state.rules)
+            changed = changed || apply(state, sentence);
+    } while(changed);
+}
+}
+
+void step(const State& in, UserInput input, State& out) {
+    if(&in != &out) { out = in; }
+    for(Entity& entity : out.entities) { entity.dRow = entity.dCol = 0; }
+
+    switch(input) {
+        case UserInput::UP: movePlayer(out, UP.first, UP.second); break;
+        case UserInput::DOWN: movePlayer(out, DOWN.first, DOWN.second); break;
+        case UserInput::LEFT: movePlayer(out, LEFT.first, LEFT.second); break;
+        case UserInput::RIGHT: movePlayer(out, RIGHT.first, RIGHT.second); break;
+        case UserInput::RESET:
+            if(out.initial) {
+                out.rows = out.initial->rows;
+                out.cols = out.initial->cols;
+                out.entities = out.initial->entities;
+            }
+            break;
+        case UserInput::QUIT: out.gameOver = true; break;
+        default: break;
+    }
+
+    out.player = NONE;
+    applyPermanentRules(out);
+    updateRules(out);
+    applyRules(out);
+}
+
+State fromMap(const Map& map, EntityType player) {
+    State result{static_cast<std::int16_t>(map.size.first), static_cast<std::int16_t>(map.size.second), player, false, {}, {}, nullptr};
+    result.entities.reserve(map.entities.size());
+    for(const MapEntity& entity : map.entities)
+        result.entities.push_back({static_cast<std::int16_t>(entity.getPosition().first), static_cast<std::int16_t>(entity.getPosition().second), static_cast<std::uint8_t>(entity.getType()), 0, 0, 0});
+    return result;
+}
+
+State fromCoreState(const CoreState& state, State& initial) {
+    State result{static_cast<std::int16_t>(state.size.first), static_cast<std::int16_t>(state.size.second), state.playerEntity, state.gameOver, {}, {}, nullptr};
+    initial = State{result.rows, result.cols, NONE, false, {}, {}, nullptr};
+    for(const PackedEntity& entity : state.initialEntities)
+        initial.entities.push_back({static_cast<std::int16_t>(entity.row), static_cast<std::int16_t>(entity.col), entity.type, 0, 0, 0});
+    for(const PackedEntity& entity : state.entities)
+        result.entities.push_back({static_cast<std::int16_t>(entity.row), static_cast<std::int16_t>(entity.col), entity.type, 0, 0, 0});
+    result.rules = state.rules;
+    result.initial = &initial;
+    return result;
+}
+
+void toMap(const State& state, Map& map) {
+    map.size = {state.rows, state.cols};
+    map.entities.clear();
+    map.entities.reserve(state.entities.size());
+    for(const Entity& entity : state.entities)
+        map.entities.emplace_back(static_cast<EntityType>(entity.type), entity.row, entity.col, &map.size);
+}
+
+std::uint64_t hash(const State& state) {
+    std::uint64_t result{Zobrist::playerKey(state.player)};
+    for(const Entity& entity : state.entities)
+        result += Zobrist::key(static_cast<EntityType>(entity.type), Position(entity.row, entity.col));
+    return result;
+}
+};
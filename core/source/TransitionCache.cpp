@@ -0,0 +1,109 @@
+#include "../TransitionCache.h"
+
+namespace {
+// Compares everything a step sets on an entity
+bool sameEntity(const Simulation::Entity& lhs, const Simulation::Entity& rhs) {
+    return lhs.row == rhs.row && lhs.col == rhs.col && lhs.type == rhs.type && lhs.dRow == rhs.dRow && lhs.dCol == rhs.dCol && lhs.flags == rhs.flags;
+}
+}
+
+std::uint64_t TransitionCache::check(const Simulation::State& state) {
+    // FNV-1a over what step() reads besides the entity multiset covered by the Zobrist hash
+    std::uint64_t result{14695981039346656037ull};
+    auto add = [&](std::uint64_t value) { result = (result ^ value) * 1099511628211ull; };
+    add(static_cast<std::uint16_t>(state.rows));
+    add(static_cast<std::uint16_t>(state.cols));
+    add(state.gameOver);
+    add(reinterpret_cast<std::uintptr_t>(state.initial));
+    for(const Simulation::Entity& entity : state.entities)
+        add(static_cast<std::uint64_t>(static_cast<std::uint16_t>(entity.row)) << 24 ^ static_cast<std::uint64_t>(static_cast<std::uint16_t>(entity.col)) << 8 ^ entity.type);
+    return result;
+}
+
+std::size_t TransitionCache::bytes(const Transition& transition) {
+    // The transition, its list node and its index node, then its buffers
+    return sizeof(Transition) + 2*sizeof(void*) + sizeof(Key) + 3*sizeof(void*)
+        + transition.indices.capacity()*sizeof(std::uint32_t)
+        + transition.entities.capacity()*sizeof(Simulation::Entity)
+        + transition.rules.capacity()*sizeof(Sentence);
+}
+
+void TransitionCache::apply(const Transition& transition, const Simulation::State& in, Simulation::State& out) {
+    if(&in != &out) { out = in; }
+    out.rows = transition.rows;
+    out.cols = transition.cols;
+    out.player = transition.player;
+    out.gameOver = transition.gameOver;
+    out.rules = transition.rules;
+    if(transition.replaced) {
+        out.entities = transition.entities;
+        return;
+    }
+    for(Simulation::Entity& entity : out.entities) { entity.dRow = entity.dCol = 0; }
+    for(std::size_t i{}; i<transition.indices.size(); ++i)
+        out.entities[transition.indices[i]] = transition.entities[i];
+}
+
+void TransitionCache::store(const Key& key, const Simulation::State& in, const Simulation::State& out) {
+    Transition transition{key, false, out.rows, out.cols, out.player, out.gameOver, {}, {}, out.rules};
+    if(in.entities.size() == out.entities.size()) {
+        for(std::size_t i{}; i<out.entities.size(); ++i) {
+            Simulation::Entity before{in.entities[i]};
+            before.dRow = before.dCol = 0;
+            if(!sameEntity(before, out.entities[i])) {
+                transition.indices.push_back(i);
+                transition.entities.push_back(out.entities[i]);
+            }
+        }
+    }
+    // A delta touching most entities is not smaller than the successor itself
+    if(in.entities.size() != out.entities.size() || 2*transition.indices.size() > out.entities.size()) {
+        transition.replaced = true;
+        transition.indices.clear();
+        transition.indices.shrink_to_fit();
+        transition.entities = out.entities;
+    }
+    transition.indices.shrink_to_fit();
+    transition.entities.shrink_to_fit();
+
+    const std::size_t size{bytes(transition)};
+    if(size > _maxBytes) { return; }
+    while(_stats.bytes + size > _maxBytes) {
+        _stats.bytes -= bytes(_transitions.back());
+        _index.erase(_transitions.back().key);
+        _transitions.pop_back();
+        ++_stats.evictions;
+    }
+    _transitions.push_front(std::move(transition));
+    _index[key] = std::begin(_transitions);
+    _stats.bytes += size;
+}
+
+void TransitionCache::step(const Simulation::State& in, UserInput input, Simulation::State& out) {
+    const Key key{Simulation::hash(in), check(in), input};
+    auto found{_index.find(key)};
+    if(found != std::end(_index)) {
+        ++_stats.hits;
+        _transitions.splice(std::begin(_transitions), _transitions, found->second);
+        apply(*found->second, in, out);
+        return;
+    }
+
+    ++_stats.misses;
+    if(&in == &out) {
+        // The delta needs the state before the step
+        const Simulation::State before{in};
+        Simulation::step(before, input, out);
+        store(key, before, out);
+    }
+    else {
+        Simulation::step(in, input, out);
+        store(key, in, out);
+    }
+}
+
+void TransitionCache::clear() {
+    _transitions.clear();
+    _index.clear();
+    _stats.bytes = 0;
+}
@@ -0,0 +1,14 @@
+#include "controller/LineDriver.h"
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    if(argc == 1) { std::cout << "A file path containing a level must be specified" << std::endl; return 1; }
+
+    std::ios::sync_with_stdio(false);
+    try {
+        LineDriver driver{argv[1]};
+        driver.run(std::cin, std::cout);
+    }
+    catch(const std::exception& e) { std::cerr << e.what() << std::endl; return 1; }
+    return 0;
+}
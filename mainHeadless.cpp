@@ -0,0 +1,93 @@
+#include "core/Core.h"
+#include "utils/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+struct Run {
+    std::string level;
+    std::string script;
+    std::string status{};
+    std::uint64_t hash{};
+    std::size_t entities{};
+    unsigned long long ticks{};
+    double seconds{};
+};
+
+void play(Run& run) {
+    try {
+        std::vector<UserInput> inputs{run.script.empty() ? std::vector<UserInput>{} : LevelLoader::loadScript(run.script)};
+        // A batch run never writes save files: S is played as a tick without input.
+        std::replace(inputs.begin(), inputs.end(), UserInput::SAVE, UserInput::NONE);
+        const auto start{std::chrono::steady_clock::now()};
+        Core core{run.level};
+        core.update();
+        UserInput last{UserInput::NONE};
+        for(UserInput input : inputs) {
+            if(core.isGameOver()) { break; }
+            core.manageInput(input);
+            core.update();
+            last = input;
+            ++run.ticks;
+        }
+        run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        run.hash = core.stateHash();
+        run.entities = core.getMap().entities.size();
+        if(core.isGameOver()) { run.status = last == UserInput::QUIT ? "quit" : "win"; }
+        else {
+            const auto& you{core.getActiveRules().you};
+            const bool controlled{std::any_of(core.getMap().entities.begin(), core.getMap().entities.end(), [&](const MapEntity& entity) {
+                return you.contains(entity.getType());
+            })};
+            run.status = controlled ? "unfinished" : "loss";
+        }
+    }
+    catch(const std::exception& e) { run.status = std::string{"error: "}+e.what(); }
+}
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> levels, scripts;
+    std::size_t threads{};
+    bool readingScripts{};
+    for(int i{1}; i<argc; ++i) {
+        const std::string arg{argv[i]};
+        if(arg == "-j" && i+1 < argc) { threads = std::stoul(argv[++i]); }
+        else if(arg == "--") { readingScripts = true; }
+        else { (readingScripts ? scripts : levels).push_back(arg); }
+    }
+    if(levels.empty()) {
+        std::cout << "Usage: " << argv[0] << " [-j threads] level... [-- script...]\n"
+                  << "Plays every script on every level, without any view" << std::endl;
+        return 1;
+    }
+    if(scripts.empty()) { scripts.emplace_back(); }
+
+    std::vector<Run> runs;
+    for(const std::string& level : levels)
+        for(const std::string& script : scripts)
+            runs.push_back({level, script});
+
+    ThreadPool pool{threads};
+    const auto start{std::chrono::steady_clock::now()};
+    pool.parallelFor(runs.size(), [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i{begin}; i<end; ++i) { play(runs[i]); }
+    });
+    const double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+    unsigned long long ticks{};
+    std::size_t failures{};
+    for(const Run& run : runs) {
+        std::cout << run.level << ' ' << (run.script.empty() ? "-" : run.script) << ' ' << run.status
+                  << " ticks=" << run.ticks << " ticks/s=" << static_cast<unsigned long long>(run.seconds > 0 ? run.ticks/run.seconds : 0)
+                  << " entities=" << run.entities << " hash=" << std::hex << run.hash << std::dec << '\n';
+        ticks += run.ticks;
+        failures += run.status.starts_with("error");
+    }
+    std::cout << runs.size() << " runs, " << ticks << " ticks in " << seconds << " s, "
+              << static_cast<unsigned long long>(seconds > 0 ? ticks/seconds : 0) << " ticks/s on " << pool.size() << " threads" << std::endl;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,34 @@
+#include "controller/SessionHost.h"
+#include <csignal>
+#include <iostream>
+
+namespace {
+SessionHost* host{};
+}
+
+int main(int argc, char* argv[]) {
+    if(argc < 3) {
+        std::cout << "Usage: " << argv[0] << " socket level... [-j threads]\n"
+                  << "Hosts one game per client connected to the socket, the levels being played in turn" << std::endl;
+        return 1;
+    }
+    std::vector<std::string> levels;
+    std::size_t threads{};
+    for(int i{2}; i<argc; ++i) {
+        const std::string arg{argv[i]};
+        if(arg == "-j" && i+1 < argc) { threads = std::stoul(argv[++i]); }
+        else { levels.push_back(arg); }
+    }
+
+    try {
+        SessionHost server{argv[1], levels, threads};
+        host = &server;
+        std::signal(SIGINT, [](int) { host->stop(); });
+        std::signal(SIGTERM, [](int) { host->stop(); });
+        std::cout << "Listening on " << argv[1] << std::endl;
+        server.run();
+        std::cout << server.moveCount() << " moves played" << std::endl;
+    }
+    catch(const std::exception& e) { std::cerr << e.what() << std::endl; return 1; }
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "controller/HostProtocol.h"
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Load test of a SessionHost: every client plays random moves in batches, and restarts when its game ends
+int main(int argc, char* argv[]) {
+    if(argc < 2) {
+        std::cout << "Usage: " << argv[0] << " socket [clients] [moves per client] [moves per request]" << std::endl;
+        return 1;
+    }
+    const std::string path{argv[1]};
+    const std::size_t clients{argc > 2 ? std::stoul(argv[2]) : 100};
+    const std::size_t moves{argc > 3 ? std::stoul(argv[3]) : 10000};
+    const std::size_t batch{std::min<std::size_t>(argc > 4 ? std::stoul(argv[4]) : 32, HostProtocol::MAX_INPUTS)};
+
+    std::vector<std::thread> threads;
+    std::vector<unsigned long long> played(clients);
+    std::vector<std::string> errors(clients);
+    const auto start{std::chrono::steady_clock::now()};
+    for(std::size_t c{}; c<clients; ++c)
+        threads.emplace_back([&, c] {
+            try {
+                HostProtocol::Client client{path};
+                std::vector<UserInput> inputs(batch);
+                std::uint64_t seed{c*0x9e3779b97f4a7c15ull + 1};
+                for(std::size_t sent{}; sent<moves; sent += batch) {
+                    for(UserInput& input : inputs) {
+                        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+                        input = static_cast<UserInput>(seed % 4);
+                    }
+                    const HostProtocol::Reply reply{client.request(HostProtocol::INPUTS, inputs.data(), inputs.size())};
+                    played[c] += reply.played;
+                    if(reply.gameOver) { client.request(HostProtocol::RESTART); }
+                }
+            }
+            catch(const std::exception& e) { errors[c] = e.what(); }
+        });
+    for(std::thread& thread : threads) { thread.join(); }
+    const double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+    unsigned long long total{};
+    std::size_t failures{};
+    for(std::size_t c{}; c<clients; ++c) {
+        total += played[c];
+        if(!errors[c].empty()) { ++failures; std::cerr << "Client " << c << ": " << errors[c] << '\n'; }
+    }
+    std::cout << clients << " clients played " << total << " moves in " << seconds << " s, "
+              << static_cast<unsigned long long>(seconds > 0 ? total/seconds : 0) << " moves/s" << std::endl;
+    return failures ? 1 : 0;
+}
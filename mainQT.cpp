@@ -2,13 +2,17 @@
 #include "view/QTView.h"
 #include "controller/Controller.h"
 #include <iostream>
+#include <memory>
 
 int main(int argc, char* argv[]) {
     if(argc == 1) { std::cout << "A file path containing a level must be specified" << std::endl; return 1; }
     
-    Core core{argv[1]};
-    QTView view{core.getMap().size.first, core.getMap().size.second, argc, argv};
-    Controller controller{&core, &view};
+    // A replayed script plays the level from its start, so it neither recovers nor journals a session
+    const std::unique_ptr<Core> core{argc > 2 ? std::make_unique<Core>(argv[1]) : std::make_unique<Core>(argv[1], "saves/session")};
+    QTView view{core->getMap().size.first, core->getMap().size.second, argc, argv};
+    Controller controller{core.get(), &view};
+    // An input script given after the level is replayed first, redrawn every N inputs if N follows it
+    if(argc > 2) { controller.replay(LevelLoader::loadScript(argv[2]), argc > 3 ? std::stoul(argv[3]) : 0); }
     controller.start();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "solver/AStarSolver.h"
+#include "solver/BfsSolver.h"
+#include "solver/ExternalBfsSolver.h"
+#include "solver/IdaStarSolver.h"
+#include "solver/MacroSolver.h"
+#include "solver/ParallelSolver.h"
+#include <iostream>
+#include <sys/resource.h>
+
+namespace {
+void report(const Solution& solution, double zeroExpanded) {
+    switch(solution.status) {
+        case Solution::SOLVED:
+            std::cout << "solved in " << solution.inputs.size() << " moves ";
+            if(solution.stats.depth) { std::cout << "(" << solution.stats.depth << " steps) "; }
+            std::cout << solution.script();
+            break;
+        case Solution::UNSOLVABLE: std::cout << "unsolvable"; break;
+        case Solution::LIMIT_REACHED: std::cout << "gave up"; break;
+    }
+    const SolverStats& stats{solution.stats};
+    std::cout << "\n    expanded=" << stats.expanded << " generated=" << stats.generated << " duplicates=" << stats.duplicates
+              << " pruned=" << stats.pruned << " dead=" << stats.dead;
+    // The share of the new states found dead, which aren't expanded
+    if(stats.generated > stats.duplicates) { std::cout << " (" << 100.0*stats.dead/(stats.generated - stats.duplicates) << "%)"; }
+    if(stats.expanded) { std::cout << " branching=" << static_cast<double>(stats.generated)/stats.expanded; }
+    std::cout << " nodes/s=" << static_cast<unsigned long long>(stats.nodesPerSecond())
+              << " seconds=" << stats.seconds << " peak=" << stats.peakBytes/1024 << " KiB";
+    if(stats.diskBytes) { std::cout << " disk=" << stats.diskBytes/1024 << " KiB"; }
+    // How many expansions the heuristic saved compared to no heuristic
+    if(zeroExpanded > 0) { std::cout << " saved=" << 100*(1 - stats.expanded/zeroExpanded) << '%'; }
+    std::cout << std::endl;
+}
+}
+
+int main(int argc, char* argv[]) {
+    if(argc == 1) {
+        std::cout << "Usage: " << argv[0] << " [-a bfs|external|astar|idastar|macro|parallel] [-h heuristic|all] [-t threads] [-m memory MiB] [-n max expanded states] [-k] level...\n"
+                  << "Finds a solution of every level, the shortest one except with parallel or the you-to-win heuristic\n"
+                  << "States that can't lead to a win are dropped, unless -k keeps them\n"
+                  << "Heuristics:";
+        for(const auto& heuristic : Heuristics::all) { std::cout << ' ' << heuristic.name; }
+        std::cout << std::endl;
+        return 1;
+    }
+    SolverLimits limits;
+    std::string algorithm{"bfs"}, heuristicName{"rules"};
+    std::size_t threads{}, memory{256};
+    std::vector<std::string> levels;
+    for(int i{1}; i<argc; ++i) {
+        const std::string arg{argv[i]};
+        if(arg == "-n" && i+1 < argc) { limits.maxExpanded = std::stoull(argv[++i]); }
+        else if(arg == "-k") { limits.pruneDeadStates = false; }
+        else if(arg == "-a" && i+1 < argc) { algorithm = argv[++i]; }
+        else if(arg == "-h" && i+1 < argc) { heuristicName = argv[++i]; }
+        else if(arg == "-t" && i+1 < argc) { threads = std::stoul(argv[++i]); }
+        else if(arg == "-m" && i+1 < argc) { memory = std::stoul(argv[++i]); }
+        else { levels.push_back(arg); }
+    }
+    std::vector<Heuristics::Named> heuristics;
+    for(const auto& heuristic : Heuristics::all)
+        if(heuristicName == "all" || heuristicName == heuristic.name) { heuristics.push_back(heuristic); }
+    if(heuristics.empty()) { std::cout << "Unknown heuristic " << heuristicName << std::endl; return 1; }
+    if(algorithm == "bfs" || algorithm == "external") { heuristics.resize(1); }
+    else if(algorithm != "astar" && algorithm != "idastar" && algorithm != "macro" && algorithm != "parallel") { std::cout << "Unknown algorithm " << algorithm << std::endl; return 1; }
+
+    for(const std::string& level : levels) {
+        std::cout << level << ":" << std::endl;
+        try {
+            const Map map{LevelLoader::loadLevel(level)};
+            double zeroExpanded{};
+            for(const auto& [name, heuristic] : heuristics) {
+                Solution solution;
+                if(algorithm == "bfs") { std::cout << "  "; solution = BfsSolver{limits, threads}.solve(map); }
+                else if(algorithm == "external") { std::cout << "  "; solution = ExternalBfsSolver{memory << 20, limits}.solve(map); }
+                else {
+                    std::cout << "  " << algorithm << '/' << name << ": ";
+                    if(algorithm == "astar") { solution = AStarSolver{heuristic, limits}.solve(map); }
+                    else if(algorithm == "idastar") { solution = IdaStarSolver{heuristic, limits}.solve(map); }
+                    else if(algorithm == "macro") { solution = MacroSolver{heuristic, limits}.solve(map); }
+                    else { solution = ParallelSolver{threads, heuristic, limits}.solve(map); }
+                }
+                report(solution, heuristic == Heuristics::zero ? 0 : zeroExpanded);
+                if(heuristic == Heuristics::zero && solution.status != Solution::LIMIT_REACHED) { zeroExpanded = solution.stats.expanded; }
+            }
+        }
+        catch(const std::exception& e) { std::cout << "  error: " << e.what() << std::endl; }
+    }
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "peak resident memory: " << usage.ru_maxrss << " KiB" << std::endl;
+    return 0;
+}
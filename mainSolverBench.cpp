@@ -0,0 +1,67 @@
+#include "solver/ExternalBfsSolver.h"
+#include "solver/ParallelSolver.h"
+#include <iostream>
+#include <thread>
+
+namespace {
+std::string outcome(const Solution& solution) {
+    switch(solution.status) {
+        case Solution::SOLVED: return "solved in "+std::to_string(solution.inputs.size())+" moves";
+        case Solution::UNSOLVABLE: return "unsolvable";
+        default: return "gave up";
+    }
+}
+
+// Scaling benchmark of ParallelSolver: the same search with 1, 2, 4... threads
+void benchThreads(const Map& map, std::size_t maxThreads, SolverLimits limits) {
+    double baseline{};
+    std::cout << "threads\tseconds\texpanded\tnodes/s\tspeedup\tefficiency\toutcome" << std::endl;
+    for(std::size_t threads{1}; threads<=maxThreads; threads = threads < maxThreads && threads*2 > maxThreads ? maxThreads : threads*2) {
+        const Solution solution{ParallelSolver{threads, Heuristics::rules, limits, limits.maxExpanded*8}.solve(map)};
+        const double rate{solution.stats.nodesPerSecond()};
+        if(threads == 1) { baseline = rate; }
+        std::cout << threads << '\t' << solution.stats.seconds << '\t' << solution.stats.expanded << '\t'
+                  << static_cast<unsigned long long>(rate) << '\t' << (baseline > 0 ? rate/baseline : 0) << '\t'
+                  << (baseline > 0 ? rate/baseline/threads : 0) << '\t' << outcome(solution) << std::endl;
+        if(threads == maxThreads) { break; }
+    }
+}
+
+// Benchmark of ExternalBfsSolver: the same search with less and less memory, spilling more and more to disk
+void benchMemory(const Map& map, std::size_t maxMiB, SolverLimits limits) {
+    std::cout << "memory\tseconds\texpanded\tstates/s\tdisk\toutcome" << std::endl;
+    for(std::size_t bytes{maxMiB << 20}; bytes>=std::size_t{64} << 10; bytes /= 4) {
+        const Solution solution{ExternalBfsSolver{bytes, limits}.solve(map)};
+        std::cout << bytes/1024 << " KiB\t" << solution.stats.seconds << '\t' << solution.stats.expanded << '\t'
+                  << static_cast<unsigned long long>(solution.stats.nodesPerSecond()) << '\t'
+                  << solution.stats.diskBytes/1024 << " KiB\t" << outcome(solution) << std::endl;
+    }
+}
+}
+
+int main(int argc, char* argv[]) {
+    if(argc == 1) {
+        std::cout << "Usage: " << argv[0] << " [-t max threads | -m max memory MiB] [-n max expanded states] level\n"
+                  << "Measures how the parallel solver scales with the number of threads,\n"
+                  << "or how fast the external solver is with 1/4, 1/16... of the memory" << std::endl;
+        return 1;
+    }
+    std::size_t maxThreads{std::max(1u, std::thread::hardware_concurrency())}, maxMiB{};
+    SolverLimits limits{1'000'000};
+    std::string level;
+    for(int i{1}; i<argc; ++i) {
+        const std::string arg{argv[i]};
+        if(arg == "-t" && i+1 < argc) { maxThreads = std::stoul(argv[++i]); }
+        else if(arg == "-m" && i+1 < argc) { maxMiB = std::stoul(argv[++i]); }
+        else if(arg == "-n" && i+1 < argc) { limits.maxExpanded = std::stoull(argv[++i]); }
+        else { level = arg; }
+    }
+
+    try {
+        const Map map{LevelLoader::loadLevel(level)};
+        if(maxMiB) { benchMemory(map, maxMiB, limits); }
+        else { benchThreads(map, maxThreads, limits); }
+    }
+    catch(const std::exception& e) { std::cout << e.what() << std::endl; return 1; }
+    return 0;
+}
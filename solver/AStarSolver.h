@@ -0,0 +1,44 @@
+/**
+    @file AStarSolver.h
+    @brief Defines the AStarSolver class, a best-first solver guided by a heuristic.
+*/
+
+#ifndef ASTARSOLVER_H
+#define ASTARSOLVER_H
+
+#include "Heuristics.h"
+#include "Solver.h"
+
+/**
+    @brief Finds a winning sequence of moves by an A* search.
+    @details States are expanded by increasing number of moves plus estimate, the deepest first among
+    equals. A state reached again with fewer moves is expanded again, so the solution is the shortest
+    whenever the heuristic never overestimates. States are kept until they are expanded.
+*/
+class AStarSolver {
+    Heuristic _heuristic;
+    SolverLimits _limits;
+public:
+    /**
+        @brief Constructs a solver.
+        @param heuristic The estimate of the moves left.
+        @param limits The limits of each search.
+    */
+    explicit AStarSolver(Heuristic heuristic = Heuristics::rules, SolverLimits limits = {}) : _heuristic{heuristic}, _limits{limits} {}
+
+    /**
+        @brief Solves a level.
+        @param map The level.
+        @return The solution and the counters of the search.
+    */
+    Solution solve(const Map& map) const { return solve(solverStart(map)); }
+
+    /**
+        @brief Solves a game from a given state.
+        @param start The state to start from.
+        @return The solution and the counters of the search.
+    */
+    Solution solve(const Simulation::State& start) const;
+};
+
+#endif // ASTARSOLVER_H
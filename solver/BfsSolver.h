@@ -0,0 +1,50 @@
+/**
+    @file BfsSolver.h
+    @brief Defines the BfsSolver class, which finds the shortest solution of a level.
+*/
+
+#ifndef BFSSOLVER_H
+#define BFSSOLVER_H
+
+#include "Solver.h"
+
+/**
+    @brief Finds a shortest winning sequence of moves by a breadth-first search.
+    @details States are advanced with Simulation::step, which plays exactly like Core. Every state seen
+    is kept packed in a PackedStateTable, which tells states apart exactly, along with its parent and
+    its move; the current and the next depths are lists of identifiers in that table.
+
+    With several threads, each depth is expanded in parallel. The children of a depth are then
+    deduplicated by partition of their hashes, each partition by one thread, in the order the
+    sequential search generates them. The solution and the counters are thus exactly those of the
+    sequential search, whatever the number of threads.
+*/
+class BfsSolver {
+    SolverLimits _limits;
+    std::size_t _threads;
+
+    Solution solveParallel(const Simulation::State& start) const;
+public:
+    /**
+        @brief Constructs a solver.
+        @param limits The limits of each search.
+        @param threads The number of threads searching, 0 to use every core.
+    */
+    explicit BfsSolver(SolverLimits limits = {}, std::size_t threads = 1) : _limits{limits}, _threads{threads} {}
+
+    /**
+        @brief Solves a level.
+        @param map The level.
+        @return The solution, with the fewest moves, and the counters of the search.
+    */
+    Solution solve(const Map& map) const { return solve(solverStart(map)); }
+
+    /**
+        @brief Solves a game from a given state.
+        @param start The state to start from.
+        @return The solution, with the fewest moves, and the counters of the search.
+    */
+    Solution solve(const Simulation::State& start) const;
+};
+
+#endif // BFSSOLVER_H
@@ -0,0 +1,57 @@
+/**
+    @file DeadStates.h
+    @brief Defines the detection of the states from which a level can no longer be won, used by the solvers.
+*/
+
+#ifndef DEADSTATES_H
+#define DEADSTATES_H
+
+#include "../core/Simulation.h"
+#include <cstdint>
+
+/**
+    @brief Namespace containing the cheap tests telling that a state can never lead to a win.
+    @details The tests only rely on facts that no move can undo:
+    - The player only moves the entities of its YOU type: without any, nothing moves anymore.
+    - Texts are never transformed, only sunk or killed, and the only ones created are the IS texts a
+      NOUN IS IS sentence turns entities into. Such a sentence needs an IS text in its middle, with room on
+      both sides, so an IS text is only created while a usable one is left.
+    - A text on an edge of the map stays on it, since pushing it away from the edge would take an entity
+      coming from outside. In a corner, a text can't move at all.
+
+    So without an active WIN sentence, a win needs a WIN text with a free cell on its left or above for
+    an IS text, an IS text with room on both sides in a row or in a column, and a noun text with a free
+    cell on its right or below. A state where some of them are all gone or all stuck in such corners is
+    dead. The tests never drop a state from which the game can be won.
+*/
+namespace DeadStates {
+/**
+    @brief Why a state is dead.
+*/
+enum Reason : std::uint8_t {
+    ALIVE, // Maybe winnable
+    NO_YOU, // No YOU sentence, or no entity of the YOU type left
+    NO_WIN_TEXT, // No WIN sentence, and every WIN text is gone or stuck in the top left corner
+    NO_IS_TEXT, // No WIN sentence, and every IS text is gone or stuck in a corner
+    NO_NOUN_TEXT // No WIN sentence, and every noun text is gone or stuck in the bottom right corner
+};
+
+/**
+    @brief The number of reasons, ALIVE included.
+*/
+constexpr std::size_t REASONS{NO_NOUN_TEXT+1};
+
+/**
+    @brief The name of every reason.
+*/
+constexpr const char* names[REASONS]{"alive", "no-you", "no-win-text", "no-is-text", "no-noun-text"};
+
+/**
+    @brief Tells whether a state can still lead to a win.
+    @param state The state, as left by Simulation::step.
+    @return ALIVE, or why the state is dead.
+*/
+Reason check(const Simulation::State& state);
+};
+
+#endif // DEADSTATES_H
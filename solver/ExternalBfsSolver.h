@@ -0,0 +1,56 @@
+/**
+    @file ExternalBfsSolver.h
+    @brief Defines the ExternalBfsSolver class, a breadth-first search keeping its states on disk.
+*/
+
+#ifndef EXTERNALBFSSOLVER_H
+#define EXTERNALBFSSOLVER_H
+
+#include "Solver.h"
+#include <filesystem>
+
+/**
+    @brief Finds a shortest winning sequence of moves by a breadth-first search with delayed duplicate detection.
+    @details Only a bounded buffer of states is held in memory; the depths and the states seen live on disk,
+    packed by PackedState, as files of records sorted by their encoding. The children of a depth are
+    collected in the buffer, which is sorted and written as a run whenever it is full. Once the depth is
+    expanded, the runs are merged with the file of the states seen in one sequential pass, which drops the
+    duplicates and writes the next depth along with the new file of states seen. Too many runs to be
+    merged at once are first merged by groups. Every file is read and written through a large buffer. Every depth is kept until
+    the end, so that the path to the winning state can be found again by expanding them backwards.
+
+    The solution has the fewest moves, like the one of BfsSolver, but can be another one of that length.
+*/
+class ExternalBfsSolver {
+    std::size_t _memoryBytes;
+    SolverLimits _limits;
+    std::filesystem::path _directory;
+public:
+    /**
+        @brief Constructs a solver.
+        @param memoryBytes The size of the buffer of states, which bounds the memory of a search.
+        @param limits The limits of each search.
+        @param directory The directory where each search creates, then removes, its own directory of files.
+    */
+    explicit ExternalBfsSolver(std::size_t memoryBytes = std::size_t{256} << 20, SolverLimits limits = {},
+        std::filesystem::path directory = std::filesystem::temp_directory_path())
+        : _memoryBytes{memoryBytes}, _limits{limits}, _directory{std::move(directory)} {}
+
+    /**
+        @brief Solves a level.
+        @param map The level.
+        @return The solution, with the fewest moves, and the counters of the search.
+        @throws std::runtime_error If the files can't be written or read.
+    */
+    Solution solve(const Map& map) const { return solve(solverStart(map)); }
+
+    /**
+        @brief Solves a game from a given state.
+        @param start The state to start from.
+        @return The solution, with the fewest moves, and the counters of the search.
+        @throws std::runtime_error If the files can't be written or read.
+    */
+    Solution solve(const Simulation::State& start) const;
+};
+
+#endif // EXTERNALBFSSOLVER_H
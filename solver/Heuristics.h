@@ -0,0 +1,83 @@
+/**
+    @file Heuristics.h
+    @brief Defines the estimates of the number of moves left, used by the informed solvers.
+*/
+
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include "../core/Simulation.h"
+#include <climits>
+
+/**
+    @typedef Heuristic
+    @brief A function estimating the number of moves left to win from a state.
+*/
+using Heuristic = unsigned (*)(const Simulation::State& state);
+
+/**
+    @brief Namespace containing the heuristics of the informed solvers.
+    @details A heuristic returns UNREACHABLE for a state from which the game can't be won, so that the
+    solvers drop it. The distances are Manhattan distances, since one move shifts an entity by one cell.
+*/
+namespace Heuristics {
+/**
+    @brief The estimate of a state from which the game can't be won.
+*/
+constexpr unsigned UNREACHABLE{UINT_MAX};
+
+/**
+    @brief Estimates nothing, which turns A* into a uniform-cost search.
+    @param state The state.
+    @return 0.
+*/
+unsigned zero(const Simulation::State& state);
+
+/**
+    @brief Computes the distance from the closest YOU entity to the closest WIN entity.
+    @details Exact lower bound while the sentences stay the same; a move rewriting them can win sooner.
+    @param state The state.
+    @return The distance, 0 without a WIN sentence, UNREACHABLE without a YOU sentence.
+*/
+unsigned youToWin(const Simulation::State& state);
+
+/**
+    @brief Computes the distance from the closest WIN text to a cell where it would complete a sentence.
+    @details The cells right of and below an IS text complete a sentence. Texts only move by being
+    pushed, and a push moves the texts in line together, so the distance between a WIN text and an IS
+    text shrinks by at most one per move: the estimate never exceeds the moves needed to form a WIN sentence.
+    A NOUN IS IS sentence creates IS texts anywhere though, so the estimate is at most 2 while its texts are
+    on the map: one move to form it, one more to read the sentence the new IS text completes.
+    @param state The state.
+    @return The distance, 0 if a WIN sentence is active, UNREACHABLE if no WIN text or no IS text is left.
+*/
+unsigned textToSlot(const Simulation::State& state);
+
+/**
+    @brief Estimates the moves left without ever overestimating them, so that the informed solvers find a shortest solution.
+    @details The sentences only change once a text is pushed from a cell in line with it, at most as far
+    as the other pushable entities. With a WIN sentence, this is the fewest moves either to walk onto a WIN
+    entity or to push a text. Without one, this is the distance of textToSlot, or one move more than pushing
+    a text, for the IS texts a NOUN IS IS sentence would create. The YOU entities walk around the STOP
+    entities which can't be pushed, and a WIN entity which can be pushed is at its Manhattan distance.
+    The estimate is 0 while an entity is still transformed at every move.
+    @param state The state.
+    @return The estimate, UNREACHABLE without a YOU sentence or when the game can't be won.
+*/
+unsigned rules(const Simulation::State& state);
+
+/**
+    @brief A heuristic and its name.
+*/
+struct Named {
+    const char* name;
+    Heuristic function;
+};
+
+/**
+    @brief Every heuristic, by name.
+*/
+constexpr Named all[]{{"zero", zero}, {"you-to-win", youToWin}, {"text-to-slot", textToSlot}, {"rules", rules}};
+};
+
+#endif // HEURISTICS_H
@@ -0,0 +1,45 @@
+/**
+    @file IdaStarSolver.h
+    @brief Defines the IdaStarSolver class, an iterative deepening solver guided by a heuristic.
+*/
+
+#ifndef IDASTARSOLVER_H
+#define IDASTARSOLVER_H
+
+#include "Heuristics.h"
+#include "Solver.h"
+
+/**
+    @brief Finds a winning sequence of moves by an IDA* search.
+    @details Each iteration is a depth-first search dropping the states whose number of moves plus
+    estimate exceeds a bound, raised to the smallest dropped value for the next iteration. Only the
+    states of the current path are kept, and a move leading back to one of them is skipped, so the
+    memory used grows with the length of the solution only.
+*/
+class IdaStarSolver {
+    Heuristic _heuristic;
+    SolverLimits _limits;
+public:
+    /**
+        @brief Constructs a solver.
+        @param heuristic The estimate of the moves left.
+        @param limits The limits of each search.
+    */
+    explicit IdaStarSolver(Heuristic heuristic = Heuristics::rules, SolverLimits limits = {}) : _heuristic{heuristic}, _limits{limits} {}
+
+    /**
+        @brief Solves a level.
+        @param map The level.
+        @return The solution and the counters of the search.
+    */
+    Solution solve(const Map& map) const { return solve(solverStart(map)); }
+
+    /**
+        @brief Solves a game from a given state.
+        @param start The state to start from.
+        @return The solution and the counters of the search.
+    */
+    Solution solve(const Simulation::State& start) const;
+};
+
+#endif // IDASTARSOLVER_H
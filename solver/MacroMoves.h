@@ -0,0 +1,81 @@
+/**
+    @file MacroMoves.h
+    @brief Defines the MacroMoves class, which collapses the free walks of the player into single moves.
+*/
+
+#ifndef MACROMOVES_H
+#define MACROMOVES_H
+
+#include "Solver.h"
+#include <cstdint>
+#include <vector>
+
+/**
+    @brief Generates the macro-moves of states: walking freely to a cell, then acting once.
+    @details A cell is free when none of its entities is a text, which is always pushable, nor of a type
+    named as the subject of a sentence; or when it is empty, if the YOU entity sinks or kills. Walking onto a free cell moves the YOU entity and nothing else,
+    so the cells it can walk to are found by a flood fill, without stepping. A macro-move then teleports
+    the YOU entity to one of them and plays, with Simulation::step, a move towards a neighbouring cell
+    which isn't free. Its inputs are the shortest walk found by the flood fill followed by that move.
+    Moves changing nothing at all are skipped, since walking alone never leads anywhere new.
+
+    With several YOU entities, which walk together, or none, the macro-moves are the primitive moves. So
+    they are while a NOUN IS IS sentence is active, since the IS texts it creates complete sentences which
+    are only read by the next move.
+*/
+class MacroMoves {
+    static constexpr Direction directions[]{UP, DOWN, LEFT, RIGHT}; // Those of solverMoves
+
+    std::size_t _you{}; // The index of the only YOU entity
+    std::int16_t _cols{};
+    std::vector<std::uint8_t> _blocked; // By cell, whether the cell isn't free
+    std::vector<std::int32_t> _from; // By cell, the previous cell of the walk reaching it, -1 if unreached
+    std::vector<UserInput> _via; // By cell, the input entering it
+    std::vector<std::int32_t> _reached; // The cells reached, closest first
+    Simulation::State _walked;
+
+    bool reach(const Simulation::State& state);
+    void walk(std::int32_t cell, std::vector<UserInput>& inputs) const;
+public:
+    /**
+        @brief Generates the macro-moves of a state.
+        @param state The state.
+        @param child The state after each macro-move; its buffers are reused.
+        @param inputs The inputs of each macro-move; its buffer is reused.
+        @param visit Called as visit() for each macro-move, with child and inputs set.
+    */
+    template<class Visitor>
+    void expand(const Simulation::State& state, Simulation::State& child, std::vector<UserInput>& inputs, Visitor&& visit) {
+        if(!reach(state)) {
+            for(UserInput move : solverMoves) {
+                Simulation::step(state, move, child);
+                inputs.assign(1, move);
+                visit();
+            }
+            return;
+        }
+        for(std::int32_t cell : _reached)
+            for(std::size_t m{}; m<std::size(solverMoves); ++m) {
+                const UserInput move{solverMoves[m]};
+                const int row{cell / _cols + directions[m].first}, col{cell % _cols + directions[m].second};
+                if(row < 0 || col < 0 || row >= state.rows || col >= state.cols || !_blocked[row*_cols + col]) { continue; }
+                _walked = state;
+                _walked.entities[_you].row = static_cast<std::int16_t>(cell / _cols);
+                _walked.entities[_you].col = static_cast<std::int16_t>(cell % _cols);
+                Simulation::step(_walked, move, child);
+                if(!child.gameOver && unchanged(child)) { continue; }
+                walk(cell, inputs);
+                inputs.push_back(move);
+                visit();
+            }
+    }
+
+    /**
+        @brief Tells whether a state is the last walked one, untouched by the move played from it.
+        @param child The state after the move.
+        @return True if no entity changed.
+    */
+    bool unchanged(const Simulation::State& child) const;
+};
+
+#endif // MACROMOVES_H
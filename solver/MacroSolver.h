@@ -0,0 +1,50 @@
+/**
+    @file MacroSolver.h
+    @brief Defines the MacroSolver class, a best-first solver moving by walks followed by an action.
+*/
+
+#ifndef MACROSOLVER_H
+#define MACROSOLVER_H
+
+#include "Heuristics.h"
+#include "Solver.h"
+
+/**
+    @brief Finds a winning sequence of moves by an A* search over macro-moves.
+    @details The successors of a state are those of its macro-moves (see MacroMoves): the states the
+    player can reach by walking freely, then acting once. A search step thus crosses a whole room, which
+    shrinks both the depth of the search and the number of states kept. A macro-move costs its number of
+    inputs, and a won state is only accepted once expanded. So the solution is the shortest when the
+    heuristic never overestimates, as Heuristics::rules: a shortest solution is made of free walks, which
+    the macro-moves replace by walks at least as short, each followed by an action.
+
+    The counters count the states reached by macro-moves, and SolverStats::depth the macro-moves of
+    the solution.
+*/
+class MacroSolver {
+    Heuristic _heuristic;
+    SolverLimits _limits;
+public:
+    /**
+        @brief Constructs a solver.
+        @param heuristic The estimate of the moves left.
+        @param limits The limits of each search.
+    */
+    explicit MacroSolver(Heuristic heuristic = Heuristics::rules, SolverLimits limits = {}) : _heuristic{heuristic}, _limits{limits} {}
+
+    /**
+        @brief Solves a level.
+        @param map The level.
+        @return The solution and the counters of the search.
+    */
+    Solution solve(const Map& map) const { return solve(solverStart(map)); }
+
+    /**
+        @brief Solves a game from a given state.
+        @param start The state to start from.
+        @return The solution and the counters of the search.
+    */
+    Solution solve(const Simulation::State& start) const;
+};
+
+#endif // MACROSOLVER_H
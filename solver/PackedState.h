@@ -0,0 +1,117 @@
+/**
+    @file PackedState.h
+    @brief Defines a compact encoding of the simulated states and a table storing them inline, used by the solvers.
+*/
+
+#ifndef PACKEDSTATE_H
+#define PACKEDSTATE_H
+
+#include "../core/Simulation.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+/**
+    @brief Namespace containing the encoding of a state as its differences with a reference state.
+    @details The entities of a state are those of the initial state of the level, in the same order, some
+    of them removed, moved or transformed. A state is thus encoded against such a reference: the player,
+    the rules, then two bits per entity telling whether the next entity of the reference is kept as is,
+    removed or changed, and three bytes (cell and type) per changed entity. The order of the entities is
+    kept, since Simulation::step depends on it. Entities never move in most levels, so a state takes a few
+    bytes plus a quarter of a byte per entity.
+
+    The dimensions and the initial state are those of the reference, and the movements of the last step
+    are cleared by the next one, so none of them are encoded. Nor is the end of the game: the searches never
+    quit, so the game is won in a state whatever the moves leading to it.
+*/
+namespace PackedState {
+/**
+    @brief Encodes a state.
+    @param state The state.
+    @param reference The reference, usually the start of the search, with the same dimensions.
+    @param out The encoding; its buffer is reused.
+    @throws std::invalid_argument If the map has more than 65536 cells, or the state more than 255 rules or too many entities.
+*/
+void encode(const Simulation::State& state, const Simulation::State& reference, std::vector<std::uint8_t>& out);
+
+/**
+    @brief Decodes a state.
+    @param packed The encoding.
+    @param reference The reference the state was encoded against.
+    @param out The state, whose dimensions and initial state are left unchanged; its buffers are reused.
+*/
+void decode(std::span<const std::uint8_t> packed, const Simulation::State& reference, Simulation::State& out);
+
+/**
+    @brief Hashes an encoding.
+    @param packed The encoding.
+    @return The hash.
+*/
+std::uint64_t hash(std::span<const std::uint8_t> packed);
+};
+
+/**
+    @brief A set of encoded states, each given an identifier in the order of insertion.
+    @details The encodings are appended to one arena, preceded by their length. Open addressing with
+    linear probing finds them: a slot holds the high half of the hash and the identifier of a state, so
+    that the encodings are compared only when the hashes most likely match. States are told apart by
+    their whole encoding, so two states never collide. The table doubles when it is 3/4 full.
+*/
+class PackedStateTable {
+    std::vector<std::uint8_t> _arena;
+    std::vector<std::uint64_t> _offsets; // The position of every state in the arena, by identifier
+    std::vector<std::uint64_t> _slots; // 0 when empty, else the high half of the hash and the identifier plus 1
+    std::size_t _mask;
+
+    bool equals(std::uint32_t id, std::span<const std::uint8_t> packed) const;
+    void grow();
+public:
+    /**
+        @brief Allocates an empty table.
+        @param capacity The number of states it holds before growing.
+    */
+    explicit PackedStateTable(std::size_t capacity = 1024);
+
+    /**
+        @brief Inserts a state unless it is already there.
+        @param packed The encoding of the state.
+        @return The identifier of the state, and whether this call inserted it.
+        @throws std::length_error If the encoding or the number of states is too large.
+    */
+    std::pair<std::uint32_t, bool> insert(std::span<const std::uint8_t> packed) { return insert(packed, PackedState::hash(packed)); }
+
+    /**
+        @brief Inserts a state unless it is already there.
+        @param packed The encoding of the state.
+        @param hash The hash of the encoding, as computed by PackedState::hash.
+        @return The identifier of the state, and whether this call inserted it.
+        @throws std::length_error If the encoding or the number of states is too large.
+    */
+    std::pair<std::uint32_t, bool> insert(std::span<const std::uint8_t> packed, std::uint64_t hash);
+
+    /**
+        @brief Gets the encoding of a state.
+        @param id The identifier of the state.
+        @return The encoding, valid until the next insertion.
+    */
+    std::span<const std::uint8_t> get(std::uint32_t id) const {
+        const std::uint64_t offset{_offsets[id]};
+        return {_arena.data() + offset + 2, static_cast<std::size_t>(_arena[offset] | _arena[offset+1] << 8)};
+    }
+
+    /**
+        @brief Gets the number of states.
+        @return The number of states.
+    */
+    std::size_t size() const { return _offsets.size(); }
+
+    /**
+        @brief Gets the memory held by the table.
+        @return The number of bytes allocated.
+    */
+    std::size_t bytes() const { return _arena.capacity() + _offsets.capacity()*sizeof(std::uint64_t) + _slots.capacity()*sizeof(std::uint64_t); }
+};
+
+#endif // PACKEDSTATE_H
@@ -0,0 +1,52 @@
+/**
+    @file ParallelSolver.h
+    @brief Defines the ParallelSolver class, which searches a solution on every core.
+*/
+
+#ifndef PARALLELSOLVER_H
+#define PARALLELSOLVER_H
+
+#include "Heuristics.h"
+#include "Solver.h"
+#include <cstddef>
+
+/**
+    @brief Finds a winning sequence of moves with a depth-first search spread over threads by work stealing.
+    @details Every thread owns a deque of states to expand: it pushes and pops at the back, going
+    depth-first with the children of a state in the order of a heuristic, while an idle thread steals
+    from the front of another deque, taking the oldest and thus largest pieces of work. A thread
+    finding nothing to steal sleeps until another one pushes new states. The states seen are shared
+    in a lock-free VisitedTable, so each is expanded by one thread only. Each search starts its own
+    threads. The solution found is the first one, not necessarily the shortest: see BfsSolver for that.
+*/
+class ParallelSolver {
+    Heuristic _heuristic;
+    std::size_t _threads;
+    SolverLimits _limits;
+    std::size_t _tableCapacity;
+public:
+    /**
+        @brief Constructs a solver.
+        @param threads The number of search threads, 0 to use every core.
+        @param heuristic The estimate ordering the children of a state, and dropping the dead ends.
+        @param limits The limits of each search.
+        @param tableCapacity The number of states the visited table can hold; the search gives up once it is full.
+    */
+    explicit ParallelSolver(std::size_t threads = 0, Heuristic heuristic = Heuristics::rules, SolverLimits limits = {}, std::size_t tableCapacity = std::size_t{1} << 24);
+
+    /**
+        @brief Solves a level.
+        @param map The level.
+        @return The solution and the counters of the search.
+    */
+    Solution solve(const Map& map) const { return solve(solverStart(map)); }
+
+    /**
+        @brief Solves a game from a given state.
+        @param start The state to start from.
+        @return The solution and the counters of the search.
+    */
+    Solution solve(const Simulation::State& start) const;
+};
+
+#endif // PARALLELSOLVER_H
@@ -0,0 +1,96 @@
+/**
+    @file Solver.h
+    @brief Defines the results shared by the level solvers.
+*/
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "DeadStates.h"
+#include "../core/Map.h"
+#include "../core/Simulation.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+    @brief Counters of a search.
+*/
+struct SolverStats {
+    std::uint64_t expanded{}; // States whose successors were generated
+    std::uint64_t generated{}; // Successors generated, duplicates included
+    std::uint64_t duplicates{}; // Successors already seen
+    std::uint64_t pruned{}; // Successors discarded by a heuristic, as dead ends or beyond the bound of an iteration
+    std::uint64_t dead{}; // States dropped by DeadStates::check before their expansion
+    std::size_t peakBytes{}; // Peak memory held by the search structures, approximately
+    std::uint64_t diskBytes{}; // Bytes written to disk by a search spilling its states
+    std::uint64_t depth{}; // Steps of the search to the solution, when a step plays several moves
+    double seconds{};
+
+    /**
+        @brief Computes the number of states expanded per second.
+        @return The throughput, 0 if nothing was expanded.
+    */
+    double nodesPerSecond() const { return seconds > 0 ? expanded / seconds : 0; }
+};
+
+/**
+    @brief Limits and options of a search.
+*/
+struct SolverLimits {
+    std::uint64_t maxExpanded{50'000'000}; // The search gives up after expanding this many states
+    bool pruneDeadStates{true}; // Whether to drop the states DeadStates::check finds dead
+};
+
+/**
+    @brief The outcome of a search.
+*/
+struct Solution {
+    /**
+        @brief How the search ended.
+    */
+    enum Status { SOLVED, UNSOLVABLE, LIMIT_REACHED };
+
+    Status status{UNSOLVABLE};
+    std::vector<UserInput> inputs; // The winning inputs, if solved
+    SolverStats stats;
+
+    /**
+        @brief Writes the winning inputs as a script.
+        @return One character per input, as read by LevelLoader::loadScript.
+    */
+    std::string script() const {
+        std::string result;
+        for(UserInput input : inputs) { result += inputToChar(input); }
+        return result;
+    }
+};
+
+/**
+    @brief The moves tried by the solvers, undo, redo and reset being useless in a search.
+*/
+constexpr UserInput solverMoves[]{UserInput::UP, UserInput::DOWN, UserInput::LEFT, UserInput::RIGHT};
+
+/**
+    @brief Builds the state a solver starts from, as Core is right after loading a level and its first update.
+    @param map The level.
+    @return The state.
+*/
+inline Simulation::State solverStart(const Map& map) {
+    Simulation::State result{Simulation::fromMap(map)};
+    Simulation::step(result, UserInput::NONE, result);
+    return result;
+}
+
+/**
+    @brief Tells whether a solver drops a state without expanding it.
+    @param limits The options of the search.
+    @param state The state.
+    @return True if dead states are pruned and DeadStates::check finds this one dead.
+*/
+inline bool solverDrops(const SolverLimits& limits, const Simulation::State& state) {
+    return limits.pruneDeadStates && DeadStates::check(state) != DeadStates::ALIVE;
+}
+
+#endif // SOLVER_H
@@ -0,0 +1,78 @@
+/**
+    @file VisitedTable.h
+    @brief Defines the VisitedTable class, a lock-free set of state hashes shared by the search threads.
+*/
+
+#ifndef VISITEDTABLE_H
+#define VISITEDTABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+    @brief A fixed-capacity set of 64-bit hashes, which any number of threads can fill at once.
+    @details Open addressing with linear probing: a hash is inserted by a compare-and-swap on the first
+    empty slot of its probe sequence, and never removed, so a lookup never waits for another thread.
+    0 marks an empty slot, so the hash 0 is stored as 1.
+*/
+class VisitedTable {
+    std::unique_ptr<std::atomic<std::uint64_t>[]> _slots;
+    std::size_t _mask;
+    std::size_t _maxSize;
+    std::atomic<std::size_t> _size{};
+public:
+    /**
+        @brief The outcome of an insertion.
+    */
+    enum Result { INSERTED, FOUND, FULL };
+
+    /**
+        @brief Allocates an empty table.
+        @param capacity The number of slots, rounded up to a power of two; the table is full at 90%, with
+        at least one slot left empty so that a search for a missing hash ends.
+    */
+    explicit VisitedTable(std::size_t capacity)
+        : _slots{std::make_unique<std::atomic<std::uint64_t>[]>(std::bit_ceil(capacity < 2 ? 2 : capacity))},
+          _mask{std::bit_ceil(capacity < 2 ? 2 : capacity) - 1}, _maxSize{std::min((_mask+1) - (_mask+1)/10, _mask)} {}
+
+    /**
+        @brief Inserts a hash unless it is already there.
+        @param hash The hash.
+        @return INSERTED if this call inserted it, FOUND if it was there, FULL if there was no room left.
+    */
+    Result insert(std::uint64_t hash) {
+        if(!hash) { hash = 1; }
+        // The low bits of a Zobrist hash are as random as the high ones
+        for(std::size_t slot{hash & _mask};; slot = (slot + 1) & _mask) {
+            std::uint64_t current{_slots[slot].load(std::memory_order_relaxed)};
+            if(current == hash) { return FOUND; }
+            if(current) { continue; }
+            // Room is claimed first, so that concurrent insertions never fill the last empty slot
+            if(_size.fetch_add(1, std::memory_order_relaxed) >= _maxSize) {
+                _size.fetch_sub(1, std::memory_order_relaxed);
+                return FULL;
+            }
+            if(_slots[slot].compare_exchange_strong(current, hash, std::memory_order_relaxed)) { return INSERTED; }
+            _size.fetch_sub(1, std::memory_order_relaxed);
+            if(current == hash) { return FOUND; }
+        }
+    }
+
+    /**
+        @brief Gets the number of hashes in the table.
+        @return The number of hashes.
+    */
+    std::size_t size() const { return _size.load(std::memory_order_relaxed); }
+
+    /**
+        @brief Gets the number of slots.
+        @return The capacity.
+    */
+    std::size_t capacity() const { return _mask + 1; }
+};
+
+#endif // VISITEDTABLE_H
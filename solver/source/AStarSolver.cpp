@@ -0,0 +1,97 @@
+#include "../AStarSolver.h"
+#include "../PackedState.h"
+#include <algorithm>
+#include <chrono>
+#include <queue>
+
+namespace {
+struct Node {
+    std::uint32_t parent;
+    UserInput input;
+    unsigned moves;
+};
+
+struct Open {
+    unsigned estimate; // moves + heuristic
+    unsigned moves;
+    std::uint32_t node;
+    std::uint32_t state; // The identifier of the state in the table of the states seen
+
+    // std::priority_queue pops the greatest element: the smallest estimate, then the most moves
+    bool operator<(const Open& other) const {
+        return estimate != other.estimate ? estimate > other.estimate : moves < other.moves;
+    }
+};
+
+std::size_t stateBytes(const Simulation::State& state) {
+    return sizeof(state) + state.entities.capacity()*sizeof(Simulation::Entity) + state.rules.capacity()*sizeof(Sentence);
+}
+}
+
+Solution AStarSolver::solve(const Simulation::State& start) const {
+    const auto begin{std::chrono::steady_clock::now()};
+    Solution result;
+    SolverStats& stats{result.stats};
+    std::vector<Node> nodes{{0, UserInput::NONE, 0}};
+    auto finish = [&](Solution::Status status, std::size_t node) {
+        result.status = status;
+        if(status == Solution::SOLVED) {
+            for(; node != 0; node = nodes[node].parent) { result.inputs.push_back(nodes[node].input); }
+            std::reverse(result.inputs.begin(), result.inputs.end());
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return result;
+    };
+    if(start.gameOver) { return finish(Solution::SOLVED, 0); }
+    if(solverDrops(_limits, start)) { ++stats.dead; return finish(Solution::UNSOLVABLE, 0); }
+    const unsigned estimate{_heuristic(start)};
+    if(estimate == Heuristics::UNREACHABLE) { ++stats.pruned; return finish(Solution::UNSOLVABLE, 0); }
+
+    // The states waiting to be expanded, by node, and the fewest moves found to reach each state seen, by
+    // identifier. States are told apart by their whole encoding, since the order of the entities matters.
+    std::vector<Simulation::State> states{start};
+    PackedStateTable seen;
+    std::vector<std::uint8_t> packed;
+    PackedState::encode(start, start, packed);
+    seen.insert(packed);
+    std::vector<unsigned> fewestMoves{0};
+    std::priority_queue<Open> open;
+    open.push({estimate, 0, 0, 0});
+    std::size_t openBytes{stateBytes(start)};
+    Simulation::State child;
+    while(!open.empty()) {
+        const Open current{open.top()};
+        open.pop();
+        Simulation::State state{std::move(states[current.node])};
+        openBytes -= stateBytes(state);
+        // A stale entry, the state was reached with fewer moves since
+        if(fewestMoves[current.state] < current.moves) { continue; }
+        // Winning children are queued rather than accepted, a shorter solution may still be queued
+        if(state.gameOver) { return finish(Solution::SOLVED, current.node); }
+        if(stats.expanded >= _limits.maxExpanded) { return finish(Solution::LIMIT_REACHED, 0); }
+        ++stats.expanded;
+
+        for(UserInput move : solverMoves) {
+            Simulation::step(state, move, child);
+            ++stats.generated;
+            const unsigned moves{current.moves + 1};
+            PackedState::encode(child, start, packed);
+            const auto [id, inserted]{seen.insert(packed)};
+            if(inserted) { fewestMoves.push_back(moves); }
+            else {
+                if(fewestMoves[id] <= moves) { ++stats.duplicates; continue; }
+                fewestMoves[id] = moves;
+            }
+            nodes.push_back({current.node, move, moves});
+            if(!child.gameOver && solverDrops(_limits, child)) { ++stats.dead; states.emplace_back(); continue; }
+            const unsigned childEstimate{child.gameOver ? 0 : _heuristic(child)};
+            if(childEstimate == Heuristics::UNREACHABLE) { ++stats.pruned; states.emplace_back(); continue; }
+            openBytes += stateBytes(child);
+            states.push_back(std::move(child));
+            open.push({moves + childEstimate, moves, static_cast<std::uint32_t>(nodes.size() - 1), id});
+        }
+        stats.peakBytes = std::max(stats.peakBytes, seen.bytes() + fewestMoves.capacity()*sizeof(unsigned) + nodes.capacity()*sizeof(Node) + states.capacity()*sizeof(Simulation::State)
+            + open.size()*sizeof(Open) + openBytes);
+    }
+    return finish(Solution::UNSOLVABLE, 0);
+}
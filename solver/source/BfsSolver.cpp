@@ -0,0 +1,148 @@
+#include "../BfsSolver.h"
+#include "../PackedState.h"
+#include "../../utils/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+
+namespace {
+struct Node {
+    std::uint32_t parent;
+    UserInput input;
+};
+
+// What became of a child in the parallel search
+enum Fate : std::uint8_t { PLAYING, WON, DEAD };
+
+// A state to expand by the parallel search, and where its encoding is
+struct Queued {
+    std::uint32_t node;
+    std::uint32_t partition;
+    std::uint32_t id;
+};
+
+Solution& finish(Solution& result, Solution::Status status, std::size_t node, const std::vector<Node>& nodes, std::chrono::steady_clock::time_point begin) {
+    result.status = status;
+    if(status == Solution::SOLVED) {
+        for(; node != 0; node = nodes[node].parent) { result.inputs.push_back(nodes[node].input); }
+        std::reverse(result.inputs.begin(), result.inputs.end());
+    }
+    result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+}
+
+Solution BfsSolver::solve(const Simulation::State& start) const {
+    if(_threads != 1) { return solveParallel(start); }
+    const auto begin{std::chrono::steady_clock::now()};
+    Solution result;
+    SolverStats& stats{result.stats};
+
+    std::vector<Node> nodes{{0, UserInput::NONE}};
+    if(start.gameOver) { return finish(result, Solution::SOLVED, 0, nodes, begin); }
+    if(solverDrops(_limits, start)) { ++stats.dead; return finish(result, Solution::UNSOLVABLE, 0, nodes, begin); }
+
+    // Every state seen, under the number of its node
+    PackedStateTable seen;
+    std::vector<std::uint8_t> packed;
+    PackedState::encode(start, start, packed);
+    seen.insert(packed);
+    std::vector<std::uint32_t> frontier{0}, next;
+    Simulation::State state{start}, child;
+    while(!frontier.empty()) {
+        for(std::uint32_t node : frontier) {
+            if(stats.expanded >= _limits.maxExpanded) { return finish(result, Solution::LIMIT_REACHED, 0, nodes, begin); }
+            ++stats.expanded;
+            PackedState::decode(seen.get(node), start, state);
+            for(UserInput move : solverMoves) {
+                Simulation::step(state, move, child);
+                ++stats.generated;
+                PackedState::encode(child, start, packed);
+                if(!seen.insert(packed).second) { ++stats.duplicates; continue; }
+                nodes.push_back({node, move});
+                if(child.gameOver) { return finish(result, Solution::SOLVED, nodes.size() - 1, nodes, begin); }
+                if(solverDrops(_limits, child)) { ++stats.dead; continue; }
+                next.push_back(nodes.size() - 1);
+            }
+        }
+        stats.peakBytes = std::max(stats.peakBytes, seen.bytes() + nodes.capacity()*sizeof(Node) + (frontier.capacity() + next.capacity())*sizeof(std::uint32_t));
+        std::swap(frontier, next);
+        next.clear();
+    }
+    return finish(result, Solution::UNSOLVABLE, 0, nodes, begin);
+}
+
+Solution BfsSolver::solveParallel(const Simulation::State& start) const {
+    constexpr std::size_t MOVES{std::size(solverMoves)};
+    const auto begin{std::chrono::steady_clock::now()};
+    Solution result;
+    SolverStats& stats{result.stats};
+
+    std::vector<Node> nodes{{0, UserInput::NONE}};
+    if(start.gameOver) { return finish(result, Solution::SOLVED, 0, nodes, begin); }
+    if(solverDrops(_limits, start)) { ++stats.dead; return finish(result, Solution::UNSOLVABLE, 0, nodes, begin); }
+
+    ThreadPool pool{_threads};
+    const std::size_t partitions{pool.size()};
+    // The table holding a state is chosen by the high half of its hash, the low half chooses its slot
+    auto partitionOf = [partitions](std::uint64_t hash) { return static_cast<std::size_t>(hash >> 32) % partitions; };
+    std::vector<PackedStateTable> seen(partitions);
+    std::vector<std::uint8_t> packed;
+    PackedState::encode(start, start, packed);
+    const std::uint64_t startHash{PackedState::hash(packed)};
+    std::vector<Queued> frontier{{0, static_cast<std::uint32_t>(partitionOf(startHash)), seen[partitionOf(startHash)].insert(packed, startHash).first}}, next;
+
+    // The children of a depth, the one of frontier[i] by solverMoves[m] at index i*MOVES + m
+    std::vector<std::vector<std::uint8_t>> children;
+    std::vector<std::uint64_t> hashes;
+    std::vector<std::uint32_t> ids;
+    std::vector<std::uint8_t> fates, fresh;
+    while(!frontier.empty()) {
+        const std::size_t count{static_cast<std::size_t>(std::min<std::uint64_t>(frontier.size(), _limits.maxExpanded - stats.expanded))};
+        const std::size_t generated{count*MOVES};
+        if(children.size() < generated) { children.resize(generated); }
+        hashes.resize(generated);
+        ids.resize(generated);
+        fates.resize(generated);
+        fresh.resize(generated);
+        pool.parallelFor(count, [&](std::size_t first, std::size_t last) {
+            Simulation::State state{start}, child;
+            for(std::size_t i{first}; i<last; ++i) {
+                PackedState::decode(seen[frontier[i].partition].get(frontier[i].id), start, state);
+                for(std::size_t m{}; m<MOVES; ++m) {
+                    Simulation::step(state, solverMoves[m], child);
+                    PackedState::encode(child, start, children[i*MOVES + m]);
+                    hashes[i*MOVES + m] = PackedState::hash(children[i*MOVES + m]);
+                    fates[i*MOVES + m] = child.gameOver ? WON : solverDrops(_limits, child) ? DEAD : PLAYING;
+                }
+            }
+        });
+        // Scanning the children in order keeps the first child of every new state, as the sequential search does
+        pool.parallelFor(partitions, [&](std::size_t first, std::size_t last) {
+            for(std::size_t partition{first}; partition<last; ++partition)
+                for(std::size_t child{}; child<generated; ++child)
+                    if(partitionOf(hashes[child]) == partition)
+                        std::tie(ids[child], fresh[child]) = seen[partition].insert(children[child], hashes[child]);
+        });
+
+        for(std::size_t child{}; child<generated; ++child) {
+            if(child % MOVES == 0) { ++stats.expanded; }
+            ++stats.generated;
+            if(!fresh[child]) { ++stats.duplicates; continue; }
+            nodes.push_back({frontier[child / MOVES].node, solverMoves[child % MOVES]});
+            if(fates[child] == WON) { return finish(result, Solution::SOLVED, nodes.size() - 1, nodes, begin); }
+            if(fates[child] == DEAD) { ++stats.dead; continue; }
+            next.push_back({static_cast<std::uint32_t>(nodes.size() - 1), static_cast<std::uint32_t>(partitionOf(hashes[child])), ids[child]});
+        }
+        std::size_t bytes{nodes.capacity()*sizeof(Node) + (frontier.capacity() + next.capacity())*sizeof(Queued)
+            + hashes.capacity()*(sizeof(std::uint64_t) + sizeof(std::uint32_t) + 2)};
+        for(const PackedStateTable& partition : seen) { bytes += partition.bytes(); }
+        for(const auto& child : children) { bytes += sizeof(child) + child.capacity(); }
+        stats.peakBytes = std::max(stats.peakBytes, bytes);
+        if(count < frontier.size()) { return finish(result, Solution::LIMIT_REACHED, 0, nodes, begin); }
+
+        std::swap(frontier, next);
+        next.clear();
+    }
+    return finish(result, Solution::UNSOLVABLE, 0, nodes, begin);
+}
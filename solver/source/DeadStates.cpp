@@ -0,0 +1,21 @@
+#include "../DeadStates.h"
+#include <algorithm>
+
+namespace DeadStates {
+Reason check(const Simulation::State& state) {
+    if(state.player == NONE) { return NO_YOU; }
+    bool you{}, win{}, is{}, noun{};
+    const int lastRow{state.rows - 1}, lastCol{state.cols - 1};
+    for(const Simulation::Entity& entity : state.entities) {
+        if(entity.type == state.player) { you = true; }
+        else if(entity.type == WIN) { win = win || entity.row > 0 || entity.col > 0; }
+        else if(entity.type == IS) { is = is || (entity.row > 0 && entity.row < lastRow) || (entity.col > 0 && entity.col < lastCol); }
+        else if(RuleTable::subjectOf[entity.type] != NONE) { noun = noun || entity.row < lastRow || entity.col < lastCol; }
+    }
+    if(!you) { return NO_YOU; }
+    if(std::any_of(state.rules.begin(), state.rules.end(), [](const Sentence& rule) { return rule.second == WIN; })) { return ALIVE; }
+    if(!win) { return NO_WIN_TEXT; }
+    if(!is) { return NO_IS_TEXT; }
+    return noun ? ALIVE : NO_NOUN_TEXT;
+}
+};
@@ -0,0 +1,286 @@
+#include "../ExternalBfsSolver.h"
+#include "../PackedState.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace {
+// The largest number of runs merged at once, so that the files open and their buffers stay few
+constexpr std::size_t FAN_IN{64};
+
+using Record = std::span<const std::uint8_t>;
+
+// Orders the encodings as the files are sorted: bytewise, then the shortest first
+bool less(Record lhs, Record rhs) {
+    const int order{std::memcmp(lhs.data(), rhs.data(), std::min(lhs.size(), rhs.size()))};
+    return order != 0 ? order < 0 : lhs.size() < rhs.size();
+}
+
+bool equal(Record lhs, Record rhs) {
+    return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0;
+}
+
+// A file of records, each an encoding preceded by its 2-byte length, written through a large buffer
+class Writer {
+    std::unique_ptr<char[]> _buffer;
+    std::ofstream _file;
+    std::uint64_t& _written;
+public:
+    Writer(const std::filesystem::path& path, std::size_t bufferBytes, std::uint64_t& written) : _buffer{new char[bufferBytes]}, _written{written} {
+        _file.rdbuf()->pubsetbuf(_buffer.get(), bufferBytes);
+        _file.open(path, std::ios::binary | std::ios::trunc);
+        if(!_file) { throw std::runtime_error("Can't write "+path.string()); }
+    }
+
+    void write(Record record) {
+        const char length[]{static_cast<char>(record.size()), static_cast<char>(record.size() >> 8)};
+        _file.write(length, 2);
+        _file.write(reinterpret_cast<const char*>(record.data()), record.size());
+        if(!_file) { throw std::runtime_error("Can't write a search file, is the disk full?"); }
+        _written += 2 + record.size();
+    }
+};
+
+class Reader {
+    std::unique_ptr<char[]> _buffer;
+    std::ifstream _file;
+    std::vector<std::uint8_t> _record;
+public:
+    Reader(const std::filesystem::path& path, std::size_t bufferBytes) : _buffer{new char[bufferBytes]} {
+        _file.rdbuf()->pubsetbuf(_buffer.get(), bufferBytes);
+        _file.open(path, std::ios::binary);
+        if(!_file) { throw std::runtime_error("Can't read "+path.string()); }
+    }
+
+    // Reads the next record, false at the end of the file
+    bool next() {
+        unsigned char length[2];
+        if(!_file.read(reinterpret_cast<char*>(length), 2)) { return false; }
+        _record.resize(length[0] | length[1] << 8);
+        if(!_file.read(reinterpret_cast<char*>(_record.data()), _record.size())) { throw std::runtime_error("Truncated search file"); }
+        return true;
+    }
+
+    Record record() const { return _record; }
+};
+
+// Reads sorted files as one sorted stream of distinct records
+class Merger {
+    std::vector<std::unique_ptr<Reader>> _readers;
+    std::vector<std::size_t> _heads; // A heap of the readers not at their end, the smallest record first
+    std::vector<std::uint8_t> _record;
+    bool _started{};
+
+    bool after(std::size_t lhs, std::size_t rhs) const { return less(_readers[rhs]->record(), _readers[lhs]->record()); }
+public:
+    Merger(const std::vector<std::filesystem::path>& paths, std::size_t bufferBytes) {
+        for(const std::filesystem::path& path : paths) {
+            _readers.push_back(std::make_unique<Reader>(path, bufferBytes));
+            if(_readers.back()->next()) { _heads.push_back(_readers.size() - 1); }
+        }
+        std::make_heap(_heads.begin(), _heads.end(), [this](std::size_t lhs, std::size_t rhs) { return after(lhs, rhs); });
+    }
+
+    // Moves to the next distinct record, false at the end of every file
+    bool next() {
+        auto order = [this](std::size_t lhs, std::size_t rhs) { return after(lhs, rhs); };
+        while(!_heads.empty()) {
+            std::pop_heap(_heads.begin(), _heads.end(), order);
+            Reader& reader{*_readers[_heads.back()]};
+            const bool fresh{!_started || !equal(reader.record(), _record)};
+            if(fresh) { _record.assign(reader.record().begin(), reader.record().end()); }
+            if(reader.next()) { std::push_heap(_heads.begin(), _heads.end(), order); }
+            else { _heads.pop_back(); }
+            if(fresh) { _started = true; return true; }
+        }
+        return false;
+    }
+
+    Record record() const { return _record; }
+};
+
+// The children collected in memory, written as a sorted run of distinct records when full
+class Buffer {
+    std::size_t _limit;
+    std::vector<std::uint8_t> _arena;
+    std::vector<std::uint32_t> _offsets;
+public:
+    // Pages of the arena are only touched once written, so reserving it whole costs nothing up front
+    explicit Buffer(std::size_t bytes) : _limit{std::min<std::size_t>(bytes, UINT32_MAX)} { _arena.reserve(_limit); }
+
+    Record get(std::uint32_t offset) const { return {_arena.data() + offset + 2, static_cast<std::size_t>(_arena[offset] | _arena[offset+1] << 8)}; }
+
+    // Adds a record, false if it doesn't fit
+    bool add(Record record) {
+        if(_arena.size() + 2 + record.size() + (_offsets.size() + 1)*sizeof(std::uint32_t) > _limit) { return false; }
+        _offsets.push_back(_arena.size());
+        _arena.push_back(static_cast<std::uint8_t>(record.size()));
+        _arena.push_back(static_cast<std::uint8_t>(record.size() >> 8));
+        _arena.insert(_arena.end(), record.begin(), record.end());
+        return true;
+    }
+
+    bool empty() const { return _offsets.empty(); }
+
+    std::size_t bytes() const { return _arena.size() + _offsets.capacity()*sizeof(std::uint32_t); }
+
+    void writeRun(Writer& run) {
+        std::sort(_offsets.begin(), _offsets.end(), [this](std::uint32_t lhs, std::uint32_t rhs) { return less(get(lhs), get(rhs)); });
+        for(std::size_t i{}; i<_offsets.size(); ++i)
+            if(i == 0 || !equal(get(_offsets[i-1]), get(_offsets[i]))) { run.write(get(_offsets[i])); }
+        _arena.clear();
+        _offsets.clear();
+    }
+};
+
+// The directory of the files of one search, removed with them at the end
+class Directory {
+    std::filesystem::path _path;
+public:
+    explicit Directory(const std::filesystem::path& parent) {
+        static std::atomic<unsigned> searches{};
+        _path = parent / ("baba-search-" + std::to_string(::getpid()) + "-" + std::to_string(searches++));
+        std::filesystem::create_directories(_path);
+    }
+    ~Directory() {
+        std::error_code error;
+        std::filesystem::remove_all(_path, error);
+    }
+
+    std::filesystem::path depth(std::size_t depth) const { return _path / ("depth-" + std::to_string(depth)); }
+    std::filesystem::path seen(std::size_t depth) const { return _path / ("seen-" + std::to_string(depth)); }
+    std::filesystem::path run(std::size_t run) const { return _path / ("run-" + std::to_string(run)); }
+};
+}
+
+Solution ExternalBfsSolver::solve(const Simulation::State& start) const {
+    const auto begin{std::chrono::steady_clock::now()};
+    Solution result;
+    SolverStats& stats{result.stats};
+    auto finish = [&](Solution::Status status) {
+        result.status = status;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return result;
+    };
+    if(start.gameOver) { return finish(Solution::SOLVED); }
+    if(solverDrops(_limits, start)) { ++stats.dead; return finish(Solution::UNSOLVABLE); }
+
+    const Directory files{_directory};
+    std::vector<std::uint8_t> packed, parent;
+    PackedState::encode(start, start, packed);
+    {
+        Writer depth{files.depth(0), 4096, stats.diskBytes}, seen{files.seen(0), 4096, stats.diskBytes};
+        depth.write(packed);
+        seen.write(packed);
+    }
+
+    // The runs being merged and the files of the depths each hold a buffer, so that they all fit in about as much memory as the children
+    const std::size_t streamBytes{std::clamp<std::size_t>(_memoryBytes / (FAN_IN + 3), 4096, std::size_t{1} << 20)};
+    Buffer buffer{_memoryBytes};
+    std::uint64_t states{}; // Found after the start
+    std::size_t runCount{};
+    Simulation::State state{start}, child;
+    for(std::size_t depth{};; ++depth) {
+        std::vector<std::filesystem::path> runs;
+        auto spill = [&] {
+            runs.push_back(files.run(runCount++));
+            Writer run{runs.back(), streamBytes, stats.diskBytes};
+            buffer.writeRun(run);
+        };
+        {
+            Reader frontier{files.depth(depth), streamBytes};
+            while(frontier.next()) {
+                // Dead states are kept in the files like the others, so that they are only dropped once
+                PackedState::decode(frontier.record(), start, state);
+                if(depth > 0 && solverDrops(_limits, state)) { ++stats.dead; continue; }
+                if(stats.expanded >= _limits.maxExpanded) { return finish(Solution::LIMIT_REACHED); }
+                ++stats.expanded;
+                for(UserInput move : solverMoves) {
+                    Simulation::step(state, move, child);
+                    ++stats.generated;
+                    if(child.gameOver) {
+                        result.inputs.push_back(move);
+                        parent.assign(frontier.record().begin(), frontier.record().end());
+                        break;
+                    }
+                    PackedState::encode(child, start, packed);
+                    if(!buffer.add(packed)) {
+                        spill();
+                        if(!buffer.add(packed)) { throw std::runtime_error("Search buffer too small for a state"); }
+                    }
+                }
+                stats.peakBytes = std::max(stats.peakBytes, buffer.bytes() + 2*streamBytes);
+                if(!result.inputs.empty()) { break; }
+            }
+        }
+
+        // Walks back from the winning state: its parent is a child of some state of the previous depth
+        if(!result.inputs.empty()) {
+            for(std::size_t previous{depth}; previous-- > 0;) {
+                Reader candidates{files.depth(previous), streamBytes};
+                bool found{};
+                while(!found && candidates.next()) {
+                    PackedState::decode(candidates.record(), start, state);
+                    for(UserInput move : solverMoves) {
+                        Simulation::step(state, move, child);
+                        PackedState::encode(child, start, packed);
+                        if(equal(packed, parent)) {
+                            result.inputs.push_back(move);
+                            parent.assign(candidates.record().begin(), candidates.record().end());
+                            found = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            std::reverse(result.inputs.begin(), result.inputs.end());
+            return finish(Solution::SOLVED);
+        }
+        if(!buffer.empty()) { spill(); }
+
+        // Merges the runs by groups until few enough are left to be merged at once
+        while(runs.size() > FAN_IN) {
+            std::vector<std::filesystem::path> merged;
+            for(std::size_t first{}; first<runs.size(); first += FAN_IN) {
+                const std::vector<std::filesystem::path> group(runs.begin() + first, runs.begin() + std::min(first + FAN_IN, runs.size()));
+                merged.push_back(files.run(runCount++));
+                {
+                    Merger children{group, streamBytes};
+                    Writer run{merged.back(), streamBytes, stats.diskBytes};
+                    while(children.next()) { run.write(children.record()); }
+                }
+                for(const std::filesystem::path& path : group) { std::filesystem::remove(path); }
+            }
+            runs = std::move(merged);
+        }
+        stats.peakBytes = std::max(stats.peakBytes, (runs.size() + 3)*streamBytes);
+
+        // Keeps the children never seen before as the next depth, in one pass over the states seen
+        std::uint64_t added{};
+        {
+            Merger children{runs, streamBytes};
+            Reader seen{files.seen(depth), streamBytes};
+            bool seenLeft{seen.next()};
+            Writer next{files.depth(depth + 1), streamBytes, stats.diskBytes}, nextSeen{files.seen(depth + 1), streamBytes, stats.diskBytes};
+            while(children.next()) {
+                for(; seenLeft && less(seen.record(), children.record()); seenLeft = seen.next()) { nextSeen.write(seen.record()); }
+                if(seenLeft && equal(seen.record(), children.record())) { continue; }
+                next.write(children.record());
+                nextSeen.write(children.record());
+                ++added;
+            }
+            for(; seenLeft; seenLeft = seen.next()) { nextSeen.write(seen.record()); }
+        }
+        states += added;
+        stats.duplicates = stats.generated - states;
+        std::filesystem::remove(files.seen(depth));
+        for(const std::filesystem::path& path : runs) { std::filesystem::remove(path); }
+        if(added == 0) { return finish(Solution::UNSOLVABLE); }
+    }
+}
@@ -0,0 +1,153 @@
+#include "../Heuristics.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace Heuristics {
+namespace {
+bool hasWinRule(const Simulation::State& state) {
+    return std::any_of(state.rules.begin(), state.rules.end(), [](const Sentence& rule) { return rule.second == WIN; });
+}
+
+unsigned distance(int row, int col, const Simulation::Entity& entity) {
+    return std::abs(entity.row - row) + std::abs(entity.col - col);
+}
+
+// The fewest moves for the YOU entities to reach each cell, row by row, while the sentences stay the
+// same: they walk around the cells holding a STOP entity, unless it can be pushed, won on or moved
+std::vector<unsigned> walkingDistances(const Simulation::State& state, const std::vector<bool>& blocked) {
+    std::vector<unsigned> result(blocked.size(), UNREACHABLE);
+    std::vector<std::size_t> queue;
+    for(const Simulation::Entity& you : state.entities) {
+        const std::size_t cell{static_cast<std::size_t>(you.row*state.cols + you.col)};
+        if(you.type == state.player && result[cell] != 0) { result[cell] = 0; queue.push_back(cell); }
+    }
+    for(std::size_t next{}; next<queue.size(); ++next) {
+        const int row{static_cast<int>(queue[next] / state.cols)}, col{static_cast<int>(queue[next] % state.cols)};
+        for(Direction direction : {UP, DOWN, LEFT, RIGHT}) {
+            const int toRow{row + direction.first}, toCol{col + direction.second};
+            if(toRow < 0 || toRow >= state.rows || toCol < 0 || toCol >= state.cols) { continue; }
+            const std::size_t cell{static_cast<std::size_t>(toRow*state.cols + toCol)};
+            if(blocked[cell] || result[cell] != UNREACHABLE) { continue; }
+            result[cell] = result[queue[next]] + 1;
+            queue.push_back(cell);
+        }
+    }
+    return result;
+}
+
+// The distance from the closest WIN text to a cell right of or below an IS text
+unsigned slotDistance(const Simulation::State& state) {
+    unsigned result{UNREACHABLE};
+    for(const Simulation::Entity& is : state.entities) {
+        if(is.type != IS) { continue; }
+        for(const Simulation::Entity& win : state.entities)
+            if(win.type == WIN)
+                result = std::min({result, distance(is.row, is.col+1, win), distance(is.row+1, is.col, win)});
+    }
+    return result;
+}
+
+// Whether the texts of a NOUN IS IS sentence are on the map, the only way to create a text
+bool canCreateIs(const Simulation::State& state) {
+    bool noun{};
+    unsigned is{};
+    for(const Simulation::Entity& entity : state.entities) {
+        noun = noun || RuleTable::subjectOf[entity.type] != NONE;
+        if(entity.type == IS) { ++is; }
+    }
+    return noun && is >= 2;
+}
+}
+
+unsigned zero(const Simulation::State&) {
+    return 0;
+}
+
+unsigned youToWin(const Simulation::State& state) {
+    if(state.player == NONE) { return UNREACHABLE; }
+    bool winning[RuleTable::TYPE_COUNT]{};
+    for(const auto& [subject, property] : state.rules)
+        if(property == WIN) { winning[subject] = true; }
+
+    unsigned result{UNREACHABLE};
+    for(const Simulation::Entity& you : state.entities) {
+        if(you.type != state.player) { continue; }
+        for(const Simulation::Entity& win : state.entities)
+            if(winning[win.type]) { result = std::min(result, distance(you.row, you.col, win)); }
+    }
+    // Without a WIN entity, a sentence has to change first
+    return result == UNREACHABLE ? 0 : result;
+}
+
+unsigned textToSlot(const Simulation::State& state) {
+    if(hasWinRule(state)) { return 0; }
+    const unsigned result{slotDistance(state)};
+    // A NOUN IS IS sentence turns entities into IS texts, wherever they are: it is formed by the first
+    // move at best, and the sentence completed by a new IS text is read by the next one
+    return result == UNREACHABLE || !canCreateIs(state) ? result : std::min(result, 2u);
+}
+
+unsigned rules(const Simulation::State& state) {
+    if(state.player == NONE) { return UNREACHABLE; }
+    const bool winRule{hasWinRule(state)};
+    const unsigned slot{winRule ? 0 : slotDistance(state)};
+    if(slot == UNREACHABLE) { return UNREACHABLE; }
+
+    bool text[RuleTable::TYPE_COUNT]{}, pushable[RuleTable::TYPE_COUNT]{}, stop[RuleTable::TYPE_COUNT]{};
+    bool winning[RuleTable::TYPE_COUNT]{}, transformed[RuleTable::TYPE_COUNT]{};
+    for(EntityType type : RuleTable::permanentPush) { text[type] = pushable[type] = true; }
+    for(const auto& [subject, property] : state.rules) {
+        switch(RuleTable::effectOf[property]) {
+            case RuleTable::Effect::PUSH: pushable[subject] = true; break;
+            case RuleTable::Effect::STOP: stop[subject] = true; break;
+            case RuleTable::Effect::WIN: winning[subject] = true; break;
+            case RuleTable::Effect::TRANSFORM: transformed[subject] = property != subject; break;
+            default: break;
+        }
+    }
+
+    const std::size_t cells{static_cast<std::size_t>(state.rows*state.cols)};
+    std::vector<bool> blocked(cells), open(cells);
+    std::size_t pushed{};
+    for(const Simulation::Entity& entity : state.entities) {
+        // Types still changing at every move would change the walls and the players below
+        if(transformed[entity.type]) { return 0; }
+        const std::size_t cell{static_cast<std::size_t>(entity.row*state.cols + entity.col)};
+        if(pushable[entity.type] || entity.type == state.player || winning[entity.type]) { open[cell] = true; }
+        else if(stop[entity.type]) { blocked[cell] = true; }
+        if(pushable[entity.type] && !text[entity.type]) { ++pushed; }
+    }
+    for(std::size_t cell{}; cell<cells; ++cell) { blocked[cell] = blocked[cell] && !open[cell]; }
+    const std::vector<unsigned> walking{walkingDistances(state, blocked)};
+
+    // The sentences only change once a text is pushed, from a cell in line with it and at most as far as
+    // the other pushable entities
+    unsigned textPush{UNREACHABLE};
+    for(const Simulation::Entity& pushedText : state.entities) {
+        if(!text[pushedText.type]) { continue; }
+        for(Direction direction : {UP, DOWN, LEFT, RIGHT})
+            for(std::size_t steps{1}; steps<=pushed+1; ++steps) {
+                const int row{pushedText.row - static_cast<int>(steps)*direction.first}, col{pushedText.col - static_cast<int>(steps)*direction.second};
+                if(row < 0 || row >= state.rows || col < 0 || col >= state.cols || blocked[row*state.cols + col]) { break; }
+                // Plus the push itself
+                if(walking[row*state.cols + col] != UNREACHABLE) { textPush = std::min(textPush, walking[row*state.cols + col] + 1); }
+            }
+    }
+    // Without a WIN sentence, either a WIN text reaches a cell completing one, or an IS text created by
+    // a NOUN IS IS sentence completes one: the move after the push forming that sentence at best
+    if(!winRule) { return textPush == UNREACHABLE ? slot : std::min(slot, textPush + 1); }
+
+    // With one, either the sentences stay the same until a YOU entity walks onto a WIN entity...
+    unsigned result{UNREACHABLE};
+    for(const Simulation::Entity& win : state.entities) {
+        if(!winning[win.type]) { continue; }
+        if(!pushable[win.type]) { result = std::min(result, walking[win.row*state.cols + win.col]); continue; }
+        // ...which may be pushed towards it...
+        for(const Simulation::Entity& you : state.entities)
+            if(you.type == state.player) { result = std::min(result, distance(you.row, you.col, win)); }
+    }
+    // ...or a text is pushed first
+    return std::min(result, textPush);
+}
+};
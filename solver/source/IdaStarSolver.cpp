@@ -0,0 +1,106 @@
+#include "../IdaStarSolver.h"
+#include "../PackedState.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+// The depth-first search of one iteration, over a stack of states reused between iterations
+class Iteration {
+    Heuristic _heuristic;
+    const SolverLimits& _limits;
+    SolverStats& _stats;
+    std::vector<Simulation::State>& _path;
+    std::vector<std::vector<std::uint8_t>>& _packed; // The encodings of the states of the path
+    std::vector<std::uint64_t>& _hashes;
+    std::vector<UserInput>& _inputs;
+public:
+    unsigned nextBound{Heuristics::UNREACHABLE};
+    bool limitReached{};
+
+    Iteration(Heuristic heuristic, const SolverLimits& limits, SolverStats& stats, std::vector<Simulation::State>& path, std::vector<std::vector<std::uint8_t>>& packed,
+        std::vector<std::uint64_t>& hashes, std::vector<UserInput>& inputs)
+        : _heuristic{heuristic}, _limits{limits}, _stats{stats}, _path{path}, _packed{packed}, _hashes{hashes}, _inputs{inputs} {}
+
+    // Whether the state encoded in _packed[depth+1] is already on the path down to _path[depth]
+    bool onPath(std::size_t depth, std::uint64_t hash) const {
+        for(std::size_t i{0}; i <= depth; ++i)
+            if(_hashes[i] == hash && _packed[i] == _packed[depth+1]) { return true; }
+        return false;
+    }
+
+    // Searches below _path[depth], returns true once _inputs holds a solution
+    bool search(std::size_t depth, unsigned bound) {
+        if(_stats.expanded >= _limits.maxExpanded) { limitReached = true; return false; }
+        ++_stats.expanded;
+        if(_path.size() <= depth+1) { _path.emplace_back(); _packed.emplace_back(); }
+        for(UserInput move : solverMoves) {
+            Simulation::State& child{_path[depth+1]};
+            Simulation::step(_path[depth], move, child);
+            ++_stats.generated;
+            // The order of the entities matters, so states are compared by their whole encoding
+            PackedState::encode(child, _path[0], _packed[depth+1]);
+            const std::uint64_t hash{PackedState::hash(_packed[depth+1])};
+            if(onPath(depth, hash)) { ++_stats.duplicates; continue; }
+            _inputs.resize(depth+1);
+            _inputs[depth] = move;
+            if(child.gameOver) {
+                // A win beyond the bound may be longer than a solution the next iterations find
+                if(depth + 1 <= bound) { return true; }
+                ++_stats.pruned;
+                nextBound = std::min<unsigned>(nextBound, depth + 1);
+                continue;
+            }
+            if(solverDrops(_limits, child)) { ++_stats.dead; continue; }
+
+            const unsigned estimate{_heuristic(child)};
+            if(estimate == Heuristics::UNREACHABLE) { ++_stats.pruned; continue; }
+            if(depth + 1 + estimate > bound) {
+                ++_stats.pruned;
+                nextBound = std::min<unsigned>(nextBound, depth + 1 + estimate);
+                continue;
+            }
+            if(_hashes.size() <= depth+1) { _hashes.resize(depth+2); }
+            _hashes[depth+1] = hash;
+            if(search(depth+1, bound)) { return true; }
+            if(limitReached) { return false; }
+        }
+        return false;
+    }
+};
+}
+
+Solution IdaStarSolver::solve(const Simulation::State& start) const {
+    const auto begin{std::chrono::steady_clock::now()};
+    Solution result;
+    SolverStats& stats{result.stats};
+    auto finish = [&](Solution::Status status) {
+        result.status = status;
+        if(status != Solution::SOLVED) { result.inputs.clear(); }
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return result;
+    };
+    if(start.gameOver) { return finish(Solution::SOLVED); }
+    if(solverDrops(_limits, start)) { ++stats.dead; return finish(Solution::UNSOLVABLE); }
+    unsigned bound{_heuristic(start)};
+    if(bound == Heuristics::UNREACHABLE) { ++stats.pruned; return finish(Solution::UNSOLVABLE); }
+
+    std::vector<Simulation::State> path{start};
+    std::vector<std::vector<std::uint8_t>> packed(1);
+    PackedState::encode(start, start, packed[0]);
+    std::vector<std::uint64_t> hashes{PackedState::hash(packed[0])};
+    while(true) {
+        Iteration iteration{_heuristic, _limits, stats, path, packed, hashes, result.inputs};
+        const bool solved{iteration.search(0, bound)};
+        std::size_t bytes{path.capacity()*sizeof(Simulation::State) + hashes.capacity()*sizeof(std::uint64_t) + result.inputs.capacity()*sizeof(UserInput)};
+        for(const Simulation::State& state : path)
+            bytes += state.entities.capacity()*sizeof(Simulation::Entity) + state.rules.capacity()*sizeof(Sentence);
+        for(const std::vector<std::uint8_t>& encoding : packed) { bytes += sizeof(encoding) + encoding.capacity(); }
+        stats.peakBytes = std::max(stats.peakBytes, bytes);
+
+        if(solved) { return finish(Solution::SOLVED); }
+        if(iteration.limitReached) { return finish(Solution::LIMIT_REACHED); }
+        // Nothing was dropped by the bound: every state reachable without cycles was searched
+        if(iteration.nextBound == Heuristics::UNREACHABLE) { return finish(Solution::UNSOLVABLE); }
+        bound = iteration.nextBound;
+    }
+}
@@ -0,0 +1,55 @@
+#include "../MacroMoves.h"
+#include <algorithm>
+
+bool MacroMoves::reach(const Simulation::State& state) {
+    if(std::count_if(state.entities.begin(), state.entities.end(), [&](const Simulation::Entity& entity) { return entity.type == state.player; }) != 1)
+        return false;
+    // IS texts created by a NOUN IS IS sentence are only read at the next move, which may then change anything
+    if(std::any_of(state.rules.begin(), state.rules.end(), [](const Sentence& rule) { return rule.second == IS; })) { return false; }
+
+    // Texts are always pushable, and the subjects of the sentences have a property or turn into something else
+    bool active[RuleTable::TYPE_COUNT]{};
+    for(EntityType text : RuleTable::permanentPush) { active[text] = true; }
+    for(const Sentence& rule : state.rules) { active[rule.first] = true; }
+    // A YOU entity which sinks or kills changes any entity it walks onto
+    for(const auto& [subject, property] : state.rules)
+        if(subject == state.player && (property == SINK || property == KILL)) { std::fill(std::begin(active), std::end(active), true); }
+    _cols = state.cols;
+    _blocked.assign(state.rows * state.cols, 0);
+    for(std::size_t i{}; i<state.entities.size(); ++i) {
+        const Simulation::Entity& entity{state.entities[i]};
+        if(entity.type == state.player) { _you = i; }
+        else if(active[entity.type]) { _blocked[entity.row * _cols + entity.col] = 1; }
+    }
+
+    _from.assign(_blocked.size(), -1);
+    _reached.clear();
+    const std::int32_t start{state.entities[_you].row * _cols + state.entities[_you].col};
+    _from[start] = start;
+    _reached.push_back(start);
+    _via.resize(_blocked.size());
+    for(std::size_t next{}; next<_reached.size(); ++next) {
+        const std::int32_t cell{_reached[next]};
+        for(std::size_t m{}; m<std::size(solverMoves); ++m) {
+            const int row{cell / _cols + directions[m].first}, col{cell % _cols + directions[m].second};
+            if(row < 0 || col < 0 || row >= state.rows || col >= state.cols) { continue; }
+            const std::int32_t neighbour{row * _cols + col};
+            if(_blocked[neighbour] || _from[neighbour] >= 0) { continue; }
+            _from[neighbour] = cell;
+            _via[neighbour] = solverMoves[m];
+            _reached.push_back(neighbour);
+        }
+    }
+    return true;
+}
+
+void MacroMoves::walk(std::int32_t cell, std::vector<UserInput>& inputs) const {
+    inputs.clear();
+    for(; _from[cell] != cell; cell = _from[cell]) { inputs.push_back(_via[cell]); }
+    std::reverse(inputs.begin(), inputs.end());
+}
+
+bool MacroMoves::unchanged(const Simulation::State& child) const {
+    return std::equal(child.entities.begin(), child.entities.end(), _walked.entities.begin(), _walked.entities.end(),
+        [](const Simulation::Entity& lhs, const Simulation::Entity& rhs) { return lhs.row == rhs.row && lhs.col == rhs.col && lhs.type == rhs.type; });
+}
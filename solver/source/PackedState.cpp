@@ -0,0 +1,145 @@
+#include "../PackedState.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+// What happened to the next entity of the reference
+enum Change : std::uint8_t { KEPT, REMOVED, CHANGED };
+
+// How far ahead of the current entity of the reference removed entities are looked for
+constexpr std::size_t LOOKAHEAD{8};
+
+bool same(const Simulation::Entity& lhs, const Simulation::Entity& rhs) {
+    return lhs.row == rhs.row && lhs.col == rhs.col && lhs.type == rhs.type;
+}
+}
+
+namespace PackedState {
+void encode(const Simulation::State& state, const Simulation::State& reference, std::vector<std::uint8_t>& out) {
+    if(state.rows * state.cols > 65536 || state.rules.size() > UINT8_MAX || state.entities.size() + reference.entities.size() > UINT16_MAX) { throw std::invalid_argument("State too large to be packed"); }
+    out.clear();
+    out.push_back(static_cast<std::uint8_t>(state.player));
+    out.push_back(static_cast<std::uint8_t>(state.rules.size()));
+    for(const auto& [subject, property] : state.rules) {
+        out.push_back(static_cast<std::uint8_t>(subject));
+        out.push_back(static_cast<std::uint8_t>(property));
+    }
+    // The number of changes, the changes, then the changed entities
+    const std::size_t counted{out.size()};
+    out.resize(counted + 2 + (state.entities.size() + reference.entities.size() + 3) / 4);
+    std::size_t changes{}, changed{out.size()};
+    auto record = [&](Change change) {
+        out[counted + 2 + changes/4] |= change << (changes % 4 * 2);
+        ++changes;
+    };
+    const auto& entities{reference.entities};
+    for(std::size_t j{}, k{}; j<state.entities.size(); ++j, ++k) {
+        const Simulation::Entity& entity{state.entities[j]};
+        if(k < entities.size() && !same(entity, entities[k]))
+            for(std::size_t ahead{k+1}; ahead<std::min(k + LOOKAHEAD, entities.size()); ++ahead)
+                if(same(entity, entities[ahead])) {
+                    for(; k<ahead; ++k) { record(REMOVED); }
+                    break;
+                }
+        if(k < entities.size() && same(entity, entities[k])) { record(KEPT); continue; }
+        record(CHANGED);
+        const auto cell{static_cast<unsigned>(entity.row * state.cols + entity.col)};
+        out.push_back(static_cast<std::uint8_t>(cell));
+        out.push_back(static_cast<std::uint8_t>(cell >> 8));
+        out.push_back(entity.type);
+    }
+    out[counted] = static_cast<std::uint8_t>(changes);
+    out[counted+1] = static_cast<std::uint8_t>(changes >> 8);
+    // Drops the bytes of changes reserved but not needed
+    const std::size_t used{counted + 2 + (changes + 3) / 4};
+    out.erase(out.begin() + used, out.begin() + changed);
+}
+
+void decode(std::span<const std::uint8_t> packed, const Simulation::State& reference, Simulation::State& out) {
+    const std::uint8_t* bytes{packed.data()};
+    out.player = static_cast<EntityType>(*bytes++);
+    out.gameOver = false;
+    out.rules.resize(*bytes++);
+    for(Sentence& rule : out.rules) {
+        rule.first = static_cast<EntityType>(*bytes++);
+        rule.second = static_cast<EntityType>(*bytes++);
+    }
+    const std::size_t changes{static_cast<std::size_t>(bytes[0] | bytes[1] << 8)};
+    const std::uint8_t* flags{bytes + 2};
+    const std::uint8_t* changed{flags + (changes + 3) / 4};
+    out.entities.clear();
+    for(std::size_t i{}, k{}; i<changes; ++i, ++k)
+        switch(flags[i/4] >> (i % 4 * 2) & 3) {
+            case KEPT: {
+                const Simulation::Entity& kept{reference.entities[k]};
+                out.entities.push_back({kept.row, kept.col, kept.type, 0, 0, 0});
+                break;
+            }
+            case REMOVED: break;
+            default: {
+                const auto cell{static_cast<unsigned>(changed[0] | changed[1] << 8)};
+                out.entities.push_back({static_cast<std::int16_t>(cell / reference.cols), static_cast<std::int16_t>(cell % reference.cols), changed[2], 0, 0, 0});
+                changed += 3;
+            }
+        }
+}
+
+std::uint64_t hash(std::span<const std::uint8_t> packed) {
+    // Mixes 8 bytes at a time, then finalizes as splitmix64 does
+    std::uint64_t result{packed.size() * 0x9e3779b97f4a7c15ull};
+    std::size_t i{};
+    for(std::uint64_t word; i + 8 <= packed.size(); i += 8) {
+        std::memcpy(&word, packed.data() + i, 8);
+        result = (result ^ word) * 0xff51afd7ed558ccdull;
+        result ^= result >> 32;
+    }
+    for(; i<packed.size(); ++i) { result = (result ^ packed[i]) * 0x100000001b3ull; }
+    result = (result ^ (result >> 30)) * 0xbf58476d1ce4e5b9ull;
+    result = (result ^ (result >> 27)) * 0x94d049bb133111ebull;
+    return result ^ (result >> 31);
+}
+};
+
+PackedStateTable::PackedStateTable(std::size_t capacity) {
+    std::size_t slots{16};
+    while(slots/4*3 < capacity) { slots *= 2; }
+    _slots.resize(slots);
+    _mask = slots - 1;
+    _offsets.reserve(capacity);
+}
+
+bool PackedStateTable::equals(std::uint32_t id, std::span<const std::uint8_t> packed) const {
+    const std::span<const std::uint8_t> stored{get(id)};
+    return stored.size() == packed.size() && std::memcmp(stored.data(), packed.data(), packed.size()) == 0;
+}
+
+void PackedStateTable::grow() {
+    std::vector<std::uint64_t> slots(_slots.size()*2);
+    const std::size_t mask{slots.size() - 1};
+    for(std::uint32_t id{}; id<_offsets.size(); ++id) {
+        const std::uint64_t hash{PackedState::hash(get(id))};
+        std::size_t slot{hash & mask};
+        while(slots[slot]) { slot = (slot + 1) & mask; }
+        slots[slot] = (hash & 0xffffffff00000000ull) | (id + 1ull);
+    }
+    _slots = std::move(slots);
+    _mask = mask;
+}
+
+std::pair<std::uint32_t, bool> PackedStateTable::insert(std::span<const std::uint8_t> packed, std::uint64_t hash) {
+    if(packed.size() > UINT16_MAX || _offsets.size() >= UINT32_MAX) { throw std::length_error("Too many states to be packed"); }
+    const std::uint64_t tag{hash & 0xffffffff00000000ull};
+    std::size_t slot{hash & _mask};
+    for(; _slots[slot]; slot = (slot + 1) & _mask)
+        if((_slots[slot] & 0xffffffff00000000ull) == tag && equals(static_cast<std::uint32_t>(_slots[slot]) - 1, packed))
+            return {static_cast<std::uint32_t>(_slots[slot]) - 1, false};
+
+    const auto id{static_cast<std::uint32_t>(_offsets.size())};
+    _offsets.push_back(_arena.size());
+    _arena.push_back(static_cast<std::uint8_t>(packed.size()));
+    _arena.push_back(static_cast<std::uint8_t>(packed.size() >> 8));
+    _arena.insert(_arena.end(), packed.begin(), packed.end());
+    _slots[slot] = tag | (id + 1ull);
+    if(_offsets.size() > _slots.size()/4*3) { grow(); }
+    return {id, true};
+}
@@ -0,0 +1,213 @@
+#include "../ParallelSolver.h"
+#include "../VisitedTable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr std::uint64_t ROOT{UINT64_MAX};
+constexpr unsigned INDEX_BITS{40};
+
+// A state seen by a thread, referred to by its thread and its index in the nodes of that thread
+struct Node {
+    std::uint64_t parent;
+    UserInput input;
+};
+
+struct Item {
+    Simulation::State state;
+    std::uint64_t node;
+};
+
+std::size_t stateBytes(const Simulation::State& state) {
+    return sizeof(Item) + state.entities.capacity()*sizeof(Simulation::Entity) + state.rules.capacity()*sizeof(Sentence);
+}
+
+// Everything a thread owns; aligned so that two threads never write to the same cache line
+struct alignas(64) Worker {
+    std::mutex mutex;
+    std::deque<Item> items;
+    std::vector<Node> nodes;
+    SolverStats stats;
+    std::size_t queuedBytes{};
+    std::uint64_t random;
+
+    bool pop(Item& item) {
+        std::lock_guard lock{mutex};
+        if(items.empty()) { return false; }
+        item = std::move(items.back());
+        items.pop_back();
+        queuedBytes -= stateBytes(item.state);
+        return true;
+    }
+
+    bool steal(Item& item) {
+        std::lock_guard lock{mutex};
+        if(items.empty()) { return false; }
+        item = std::move(items.front());
+        items.pop_front();
+        queuedBytes -= stateBytes(item.state);
+        return true;
+    }
+
+    void push(Simulation::State&& state, std::uint64_t node) {
+        std::lock_guard lock{mutex};
+        queuedBytes += stateBytes(state);
+        items.push_back({std::move(state), node});
+        stats.peakBytes = std::max(stats.peakBytes, queuedBytes);
+    }
+};
+
+class Search {
+    Heuristic _heuristic;
+    const SolverLimits& _limits;
+    std::vector<Worker> _workers;
+    VisitedTable _visited;
+    std::atomic<std::uint64_t> _expanded{};
+    std::atomic<std::size_t> _pending{1}; // Items queued or being expanded
+    std::atomic<std::uint64_t> _events{}; // Bumped whenever an idle thread may have something to do
+    std::atomic<std::size_t> _idle{}; // Threads waiting for an event
+    std::atomic<bool> _stopping{};
+    std::atomic<Solution::Status> _status{Solution::UNSOLVABLE};
+    std::uint64_t _solution{ROOT};
+    std::mutex _solutionMutex;
+
+    bool steal(std::size_t thief, Item& item) {
+        Worker& self{_workers[thief]};
+        self.random ^= self.random << 13; self.random ^= self.random >> 7; self.random ^= self.random << 17;
+        for(std::size_t i{}, first{self.random % _workers.size()}; i<_workers.size(); ++i) {
+            const std::size_t victim{(first + i) % _workers.size()};
+            if(victim != thief && _workers[victim].steal(item)) { return true; }
+        }
+        return false;
+    }
+
+    // Wakes the idle threads up; the system call is skipped while every thread is busy
+    void signal() {
+        ++_events;
+        if(_idle > 0) { _events.notify_all(); }
+    }
+
+    void stop(Solution::Status status, std::uint64_t node = ROOT) {
+        {
+            std::lock_guard lock{_solutionMutex};
+            if(_stopping) { return; }
+            _status = status;
+            _solution = node;
+            _stopping = true;
+        }
+        signal();
+    }
+
+    // Pushes the new children with the most promising one last, so that it is expanded next
+    void expand(std::size_t id, Item& item, Simulation::State (&children)[std::size(solverMoves)]) {
+        Worker& self{_workers[id]};
+        std::pair<unsigned, std::size_t> order[std::size(solverMoves)];
+        std::size_t count{};
+        for(std::size_t i{}; i<std::size(solverMoves); ++i) {
+            Simulation::State& child{children[i]};
+            Simulation::step(item.state, solverMoves[i], child);
+            ++self.stats.generated;
+            const VisitedTable::Result result{_visited.insert(Simulation::hash(child))};
+            if(result == VisitedTable::FULL) { stop(Solution::LIMIT_REACHED); return; }
+            if(result == VisitedTable::FOUND) { ++self.stats.duplicates; continue; }
+            if(child.gameOver) {
+                self.nodes.push_back({item.node, solverMoves[i]});
+                stop(Solution::SOLVED, static_cast<std::uint64_t>(id) << INDEX_BITS | (self.nodes.size() - 1));
+                return;
+            }
+            if(solverDrops(_limits, child)) { ++self.stats.dead; continue; }
+            const unsigned estimate{_heuristic(child)};
+            if(estimate == Heuristics::UNREACHABLE) { ++self.stats.pruned; continue; }
+            // Inserted by decreasing estimate, the last child first among equals
+            std::size_t k{count++};
+            for(; k>0 && order[k-1] < std::pair{estimate, i}; --k) { order[k] = order[k-1]; }
+            order[k] = {estimate, i};
+        }
+        for(std::size_t k{}; k<count; ++k) {
+            const std::size_t i{order[k].second};
+            self.nodes.push_back({item.node, solverMoves[i]});
+            ++_pending;
+            self.push(std::move(children[i]), static_cast<std::uint64_t>(id) << INDEX_BITS | (self.nodes.size() - 1));
+        }
+        if(count > 0) { signal(); }
+    }
+public:
+    Search(Heuristic heuristic, std::size_t threads, const SolverLimits& limits, std::size_t tableCapacity, const Simulation::State& start)
+        : _heuristic{heuristic}, _limits{limits}, _workers(threads), _visited{tableCapacity} {
+        for(std::size_t id{}; id<threads; ++id) { _workers[id].random = id*0x9e3779b97f4a7c15ull + 1; }
+        _visited.insert(Simulation::hash(start));
+        _workers[0].push(Simulation::State{start}, ROOT);
+    }
+
+    void run(std::size_t id) {
+        Worker& self{_workers[id]};
+        Item item;
+        Simulation::State children[std::size(solverMoves)];
+        while(!_stopping) {
+            // Read before looking for work, so that work pushed meanwhile cuts the wait short
+            const std::uint64_t events{_events};
+            if(!self.pop(item) && !steal(id, item)) {
+                if(_pending == 0) { return; }
+                ++_idle;
+                _events.wait(events);
+                --_idle;
+                continue;
+            }
+            if(_expanded.fetch_add(1, std::memory_order_relaxed) >= _limits.maxExpanded) { stop(Solution::LIMIT_REACHED); }
+            else { expand(id, item, children); }
+            // The last item is done without a solution: the idle threads return
+            if(--_pending == 0) { signal(); }
+        }
+    }
+
+    Solution result() {
+        Solution result;
+        result.status = _status;
+        for(std::uint64_t node{_solution}; node != ROOT;) {
+            const Node& found{_workers[node >> INDEX_BITS].nodes[node & ((std::uint64_t{1} << INDEX_BITS) - 1)]};
+            result.inputs.push_back(found.input);
+            node = found.parent;
+        }
+        std::reverse(result.inputs.begin(), result.inputs.end());
+
+        SolverStats& stats{result.stats};
+        stats.expanded = std::min<std::uint64_t>(_expanded, _limits.maxExpanded);
+        stats.peakBytes = _visited.capacity()*sizeof(std::uint64_t);
+        for(const Worker& worker : _workers) {
+            stats.generated += worker.stats.generated;
+            stats.pruned += worker.stats.pruned;
+            stats.duplicates += worker.stats.duplicates;
+            stats.dead += worker.stats.dead;
+            stats.peakBytes += worker.stats.peakBytes + worker.nodes.capacity()*sizeof(Node);
+        }
+        return result;
+    }
+};
+}
+
+ParallelSolver::ParallelSolver(std::size_t threads, Heuristic heuristic, SolverLimits limits, std::size_t tableCapacity)
+    : _heuristic{heuristic}, _threads{threads ? threads : std::max(1u, std::thread::hardware_concurrency())}, _limits{limits}, _tableCapacity{tableCapacity} {}
+
+Solution ParallelSolver::solve(const Simulation::State& start) const {
+    const auto begin{std::chrono::steady_clock::now()};
+    Solution result;
+    if(start.gameOver) { result.status = Solution::SOLVED; }
+    else if(solverDrops(_limits, start)) { ++result.stats.dead; }
+    else {
+        Search search{_heuristic, _threads, _limits, _tableCapacity, start};
+        {
+            // One thread per worker id, joined at the end of the scope
+            std::vector<std::jthread> threads;
+            threads.reserve(_threads);
+            for(std::size_t id{}; id<_threads; ++id) { threads.emplace_back([&search, id] { search.run(id); }); }
+        }
+        result = search.result();
+    }
+    result.stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
@@ -1,9 +1,30 @@
 #define CATCH_CONFIG_RUNNER
 
 #include "catch.hpp"
+#include "../capi/baba.h"
+#include "../controller/Controller.h"
+#include "../controller/LineDriver.h"
+#include "../controller/SessionHost.h"
 #include "../core/MapEntity.h"
 #include "../core/Map.h"
+#include "../core/BatchEnvironment.h"
+#include "../core/BatchSimulation.h"
 #include "../core/Core.h"
+#include "../core/Replay.h"
+#include "../core/Simulation.h"
+#include "../core/TransitionCache.h"
+#include "../core/Zobrist.h"
+#include "../solver/AStarSolver.h"
+#include "../solver/BfsSolver.h"
+#include "../solver/DeadStates.h"
+#include "../solver/ExternalBfsSolver.h"
+#include "../solver/IdaStarSolver.h"
+#include "../solver/MacroMoves.h"
+#include "../solver/MacroSolver.h"
+#include "../solver/PackedState.h"
+#include "../solver/ParallelSolver.h"
+#include "../solver/VisitedTable.h"
+#include "../view/View.h"
 
 TEST_CASE("MapEntity tests") {
     std::pair<unsigned, unsigned> mapSize{10, 10};
@@ -57,6 +78,993 @@ TEST_CASE("Core tests") {
     REQUIRE(wall->getPosition().first == 0);
 }
 
+TEST_CASE("Rule cache tests") {
+    Core core{"tests/testmap.txt"};
+    core.update();
+    REQUIRE(core.getActiveRules().you.contains(WALL));
+    REQUIRE(core.getRuleCacheStats().misses == 1);
+
+    // Same sentences on the next tick
+    core.manageInput(UserInput::RIGHT);
+    core.update();
+    REQUIRE(core.getRuleCacheStats().hits == 1);
+    REQUIRE(core.getRuleCacheStats().hitRate() == 0.5);
+}
+
+TEST_CASE("Undo & redo tests") {
+    Core core{"tests/testmap.txt"};
+    core.update();
+    auto wallRow{[&core]() {
+        return std::find_if(std::begin(core.getMap().entities), std::end(core.getMap().entities), [](const auto& ent) { return ent.getType() == WALL; })->getPosition().first;
+    }};
+
+    core.manageInput(UserInput::DOWN); core.update();
+    core.manageInput(UserInput::DOWN); core.update();
+    REQUIRE(wallRow() == 2);
+    REQUIRE(core.getJournal().undoableCount() == 2);
+
+    core.manageInput(UserInput::UNDO); core.update();
+    REQUIRE(wallRow() == 1);
+    core.manageInput(UserInput::REDO); core.update();
+    REQUIRE(wallRow() == 2);
+
+    // Reset is undoable as well
+    core.manageInput(UserInput::RESET); core.update();
+    REQUIRE(wallRow() == 0);
+    core.manageInput(UserInput::UNDO); core.update();
+    REQUIRE(wallRow() == 2);
+
+    // A new move discards the redo history
+    core.manageInput(UserInput::UNDO); core.update();
+    core.manageInput(UserInput::UP); core.update();
+    REQUIRE(core.getJournal().redoableCount() == 0);
+    REQUIRE(wallRow() == 0);
+
+    // Undoing a win resumes the game, redoing it ends the game again
+    Core winner{"levels/level_0.txt"};
+    winner.update();
+    for(int move{}; move<7; ++move) { winner.manageInput(UserInput::RIGHT); winner.update(); }
+    REQUIRE(winner.isGameOver());
+    winner.manageInput(UserInput::UNDO); winner.update();
+    REQUIRE(!winner.isGameOver());
+    winner.manageInput(UserInput::REDO); winner.update();
+    REQUIRE(winner.isGameOver());
+
+    // Changes made after an undo belong to the tick before it, and discard the redo history
+    DeltaJournal journal;
+    MapDelta first, second, settled;
+    first.recordMove(0, WALL, {0, 0}, {1, 0});
+    second.recordMove(0, WALL, {1, 0}, {2, 0});
+    settled.recordType(0, WALL, ROCK, {1, 0});
+    settled.gameOverAfter = true;
+    journal.push(std::make_shared<const MapDelta>(first));
+    journal.push(std::make_shared<const MapDelta>(second));
+    journal.undo();
+    journal.amend(settled);
+    REQUIRE(journal.redoableCount() == 0);
+    const auto amended{journal.undo()};
+    REQUIRE(amended->changes.size() == 2);
+    REQUIRE(amended->changes.back().newType == ROCK);
+    REQUIRE(amended->gameOverAfter);
+}
+
+TEST_CASE("Map snapshot tests") {
+    Core core{"levels/level_0.txt"};
+    core.update();
+    MapSnapshot before{core.snapshot()};
+    REQUIRE(before.entityCount() == core.getMap().entities.size());
+
+    // Moving the player only copies the chunks holding the player
+    core.manageInput(UserInput::RIGHT); core.update();
+    MapSnapshot after{core.snapshot()};
+    unsigned shared{};
+    for(std::size_t chunk{}; chunk*MapSnapshot::CHUNK_SIZE < after.entityCount(); ++chunk)
+        shared += after.sharesChunk(before, chunk);
+    REQUIRE(shared > 0);
+    REQUIRE(shared < (after.entityCount()+MapSnapshot::CHUNK_SIZE-1)/MapSnapshot::CHUNK_SIZE);
+
+    // Branching back, without redrawing the views
+    struct Counter : nvs::Observer {
+        unsigned updates{};
+        void update(const nvs::Subject*) override { ++updates; }
+    } counter;
+    core.registerObserver(&counter);
+    core.restore(before);
+    for(std::size_t i{}; i<before.entityCount(); ++i)
+        REQUIRE(core.getMap().entities.at(i).getPosition() == before.at(i).getPosition());
+    REQUIRE(counter.updates == 0);
+    REQUIRE(core.stateHash() == Zobrist::hash(core.getMap().entities) + Zobrist::playerKey(BABA));
+    core.refreshObservers();
+    REQUIRE(counter.updates == 1);
+    core.unregisterObserver(&counter);
+}
+
+TEST_CASE("Replay tests") {
+    Core core{"levels/level_1.txt"};
+    core.update();
+    Replay replay{core.snapshot(), 16};
+    std::vector<MapSnapshot> expected{core.snapshot()};
+
+    const UserInput inputs[]{UserInput::UP, UserInput::RIGHT, UserInput::RIGHT, UserInput::DOWN, UserInput::UNDO, UserInput::LEFT, UserInput::REDO, UserInput::RESET};
+    for(unsigned tick{}; tick<200; ++tick) {
+        core.manageInput(inputs[(tick*7 + tick/3) % std::size(inputs)]);
+        core.update();
+        replay.record(core);
+        expected.push_back(core.snapshot());
+    }
+    REQUIRE(replay.tickCount() == 200);
+
+    Map map;
+    for(std::size_t tick : {0, 1, 15, 16, 17, 100, 199, 200}) {
+        replay.seek(tick, map);
+        REQUIRE(map.entities.size() == expected.at(tick).entityCount());
+        for(std::size_t i{}; i<map.entities.size(); ++i) {
+            REQUIRE(map.entities.at(i).getType() == expected.at(tick).at(i).getType());
+            REQUIRE(map.entities.at(i).getPosition() == expected.at(tick).at(i).getPosition());
+        }
+    }
+    REQUIRE_THROWS(replay.seek(201, map));
+}
+
+TEST_CASE("Session journal tests") {
+    const std::string directory{(std::filesystem::temp_directory_path() / "baba_session_test").string()};
+    std::filesystem::remove_all(directory);
+    const UserInput inputs[]{UserInput::RIGHT, UserInput::RIGHT, UserInput::UP, UserInput::UNDO, UserInput::RIGHT, UserInput::DOWN, UserInput::DOWN};
+    MapSnapshot expected;
+    {
+        Core core{"levels/level_0.txt", directory, 3};
+        for(UserInput input : inputs) { core.manageInput(input); core.update(); }
+        expected = core.snapshot();
+        // Destroyed without quitting, as in a crash
+    }
+    Core recovered{"levels/level_0.txt", directory, 3};
+    REQUIRE(recovered.getMap().entities.size() == expected.entityCount());
+    for(std::size_t i{}; i<expected.entityCount(); ++i)
+        REQUIRE(recovered.getMap().entities.at(i).getPosition() == expected.at(i).getPosition());
+
+    // Quitting ends the session
+    REQUIRE(recovered.isJournaling());
+    recovered.manageInput(UserInput::QUIT); recovered.update();
+    REQUIRE_FALSE(recovered.isJournaling());
+    REQUIRE(std::filesystem::is_empty(directory));
+    std::filesystem::remove_all(directory);
+
+    // A journal which can't be written is dropped, and the game goes on
+    std::ofstream{directory} << "not a directory";
+    Core unjournalled{"levels/level_0.txt", directory + "/session", 1};
+    REQUIRE_FALSE(unjournalled.isJournaling());
+    unjournalled.manageInput(UserInput::RIGHT); unjournalled.update();
+    std::filesystem::remove(directory);
+    {
+        Core core{"levels/level_0.txt", directory, 1};
+        REQUIRE(core.isJournaling());
+        std::filesystem::remove_all(directory);
+        std::ofstream{directory} << "not a directory";
+        core.manageInput(UserInput::RIGHT); core.update();
+        core.flushSaves();
+        core.manageInput(UserInput::RIGHT); core.update();
+        REQUIRE_FALSE(core.isJournaling());
+        REQUIRE(core.getMap().entities.size() == expected.entityCount());
+    }
+    std::filesystem::remove(directory);
+}
+
+TEST_CASE("Binary snapshot tests") {
+    Core core{"levels/level_0.txt"};
+    core.update();
+    core.manageInput(UserInput::RIGHT); core.update();
+    core.manageInput(UserInput::UP); core.update();
+
+    std::stringstream buffer;
+    BinarySnapshot::write(buffer, core.getState());
+    Core resumed{BinarySnapshot::read(buffer)};
+    REQUIRE(resumed.getMap().entities.size() == core.getMap().entities.size());
+    for(std::size_t i{}; i<core.getMap().entities.size(); ++i) {
+        REQUIRE(resumed.getMap().entities.at(i).getType() == core.getMap().entities.at(i).getType());
+        REQUIRE(resumed.getMap().entities.at(i).getPosition() == core.getMap().entities.at(i).getPosition());
+    }
+    REQUIRE(resumed.getActiveRules().sentences == core.getActiveRules().sentences);
+
+    // The initial map survives, so the resumed game can still be reset
+    resumed.manageInput(UserInput::RESET); resumed.update();
+    core.manageInput(UserInput::RESET); core.update();
+    for(std::size_t i{}; i<core.getMap().entities.size(); ++i)
+        REQUIRE(resumed.getMap().entities.at(i).getPosition() == core.getMap().entities.at(i).getPosition());
+
+    std::stringstream garbage{"BABS"};
+    REQUIRE_THROWS_AS(BinarySnapshot::read(garbage), const std::invalid_argument&);
+
+    // Corrupted counts, types and sentences are rejected before they are used
+    auto corrupted{[&core](auto corrupt) {
+        CoreState state{core.getState()};
+        BinarySnapshot::Header header{};
+        std::stringstream stream;
+        BinarySnapshot::write(stream, state);
+        std::string bytes{stream.str()};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        corrupt(header, bytes);
+        std::memcpy(bytes.data(), &header, sizeof(header));
+        std::stringstream result{bytes};
+        return result;
+    }};
+    std::stringstream huge{corrupted([](BinarySnapshot::Header& header, std::string&) { header.entityCount = UINT32_MAX; })};
+    REQUIRE_THROWS_AS(BinarySnapshot::read(huge), const std::invalid_argument&);
+    std::stringstream badType{corrupted([](BinarySnapshot::Header& header, std::string& bytes) {
+        bytes.at(sizeof(header) + header.nameLength + offsetof(PackedEntity, type)) = static_cast<char>(BEST+1);
+    })};
+    REQUIRE_THROWS_AS(BinarySnapshot::read(badType), const std::invalid_argument&);
+    std::stringstream badSentence{corrupted([](BinarySnapshot::Header&, std::string& bytes) { bytes.back() = static_cast<char>(NONE); })};
+    REQUIRE_THROWS_AS(BinarySnapshot::read(badSentence), const std::invalid_argument&);
+
+    // Positions which don't fit in the format can't be saved
+    std::pair<unsigned, unsigned> size{1u << 20, 1u << 20};
+    REQUIRE_THROWS_AS(CoreState::pack(std::vector<MapEntity>{MapEntity{BABA, 1u << 17, 0, &size}}), const std::out_of_range&);
+}
+
+TEST_CASE("Asynchronous save tests") {
+    const std::filesystem::path directory{std::filesystem::temp_directory_path() / "baba_save_test"};
+    std::filesystem::remove_all(directory);
+    auto countSaves{[&directory]() {
+        if(!std::filesystem::exists(directory)) { return 0l; }
+        return static_cast<long>(std::distance(std::filesystem::directory_iterator{directory}, std::filesystem::directory_iterator{}));
+    }};
+    std::string statePath;
+    {
+        Core core{"tests/testmap.txt"};
+        core.setSaveDirectory(directory.string());
+        core.update();
+        core.manageInput(UserInput::DOWN); core.update();
+        core.manageInput(UserInput::SAVE); core.update();
+        core.flushSaves();
+        REQUIRE(countSaves() == 2);
+        for(const auto& file : std::filesystem::directory_iterator{directory})
+            if(file.path().extension() == ".state")
+                statePath = file.path().string();
+    }
+    REQUIRE(!statePath.empty());
+    Core resumed{statePath};
+    REQUIRE(resumed.getMap().entities.front().getPosition().first == 1);
+    std::filesystem::remove_all(directory);
+
+    // A save which can't be written is counted, and the game goes on
+    const std::filesystem::path blocker{std::filesystem::temp_directory_path() / "baba_save_blocker"};
+    std::ofstream{blocker} << "not a directory";
+    Core core{"tests/testmap.txt"};
+    core.setSaveDirectory((blocker / "saves").string());
+    core.update();
+    REQUIRE(core.failedSaves() == 0);
+    REQUIRE(core.lastSaveError().empty());
+    core.manageInput(UserInput::SAVE); core.update();
+    core.flushSaves();
+    REQUIRE(core.failedSaves() == 1);
+    REQUIRE_FALSE(core.lastSaveError().empty());
+    core.manageInput(UserInput::DOWN); core.update();
+    std::filesystem::remove(blocker);
+}
+
+TEST_CASE("Zobrist hash tests") {
+    Core core{"levels/level_3.txt"};
+    core.update();
+    const std::uint64_t start{core.stateHash()};
+
+    // Going back and forth gives back the same hash
+    core.manageInput(UserInput::LEFT); core.update();
+    REQUIRE(core.stateHash() != start);
+    core.manageInput(UserInput::RIGHT); core.update();
+    REQUIRE(core.stateHash() == start);
+
+    // The incremental hash always matches a full recomputation
+    const UserInput inputs[]{UserInput::UP, UserInput::UP, UserInput::RIGHT, UserInput::DOWN, UserInput::UNDO, UserInput::LEFT, UserInput::REDO, UserInput::RIGHT, UserInput::RESET, UserInput::UNDO};
+    for(unsigned tick{}; tick<300; ++tick) {
+        core.manageInput(inputs[(tick*7 + tick/5) % std::size(inputs)]);
+        core.update();
+        REQUIRE(core.stateHash() == Zobrist::hash(core.getMap().entities) + Zobrist::playerKey(core.getActiveRules().you.empty() ? NONE : *std::begin(core.getActiveRules().you)));
+    }
+}
+
+TEST_CASE("Simulation step tests") {
+    const UserInput inputs[]{UserInput::UP, UserInput::LEFT, UserInput::LEFT, UserInput::DOWN, UserInput::RIGHT, UserInput::UP, UserInput::RESET, UserInput::DOWN, UserInput::RIGHT, UserInput::NONE};
+    for(const char* level : {"levels/level_0.txt", "levels/level_3.txt", "levels/level_4.txt"}) {
+        Core core{level};
+        core.update();
+        Simulation::State initial;
+        Simulation::State state{Simulation::fromCoreState(core.getState(), initial)};
+        REQUIRE(Simulation::hash(state) == core.stateHash());
+
+        // The pure step function and Core agree tick after tick
+        for(unsigned tick{}; tick<200 && !core.isGameOver(); ++tick) {
+            const UserInput input{inputs[(tick*3 + tick/7) % std::size(inputs)]};
+            core.manageInput(input); core.update();
+            Simulation::step(state, input, state);
+            REQUIRE(state.entities.size() == core.getMap().entities.size());
+            for(std::size_t i{}; i<state.entities.size(); ++i) {
+                REQUIRE(state.entities.at(i).type == core.getMap().entities.at(i).getType());
+                REQUIRE(Position(state.entities.at(i).row, state.entities.at(i).col) == core.getMap().entities.at(i).getPosition());
+            }
+            REQUIRE(state.rules == core.getActiveRules().sentences);
+            REQUIRE(state.gameOver == core.isGameOver());
+            REQUIRE(Simulation::hash(state) == core.stateHash());
+        }
+    }
+
+    // With two YOU sentences, every engine picks the first noun instead of switching between them forever
+    const std::filesystem::path twoYou{std::filesystem::temp_directory_path() / "baba_two_you.txt"};
+    std::ofstream{twoYou} << "6 6\ntext_baba 1 1\nis 2 1\nyou 3 1\ntext_rock 1 3\nis 2 3\nyou 3 3\nbaba 1 5\nrock 3 5\n";
+    Core twoYouCore{twoYou.string()};
+    twoYouCore.update();
+    REQUIRE(twoYouCore.getState().playerEntity == ROCK);
+    Simulation::State twoYouState{Simulation::fromMap(LevelLoader::loadLevel(twoYou.string()))};
+    Simulation::step(twoYouState, UserInput::NONE, twoYouState);
+    REQUIRE(twoYouState.player == ROCK);
+    BatchSimulation twoYouBatch{twoYouState, 1};
+    twoYouBatch.step({UserInput::UP});
+    REQUIRE(twoYouBatch.state(0).player == ROCK);
+    std::filesystem::remove(twoYou);
+
+    // Round trip through a map
+    Map map;
+    Simulation::State state{Simulation::fromMap(LevelLoader::loadLevel("tests/testmap.txt"))};
+    Simulation::toMap(state, map);
+    REQUIRE(Simulation::fromMap(map).entities.size() == state.entities.size());
+    REQUIRE(Simulation::hash(Simulation::fromMap(map)) == Simulation::hash(state));
+
+    // The rule table names the same texts as the maps of MapEntity.h
+    for(const auto& [text, noun] : textEntToRealEnt) { REQUIRE(RuleTable::subjectOf[text] == noun); }
+    for(const auto& [text, rule] : textEntToRule) { REQUIRE(RuleTable::propertyOf[text] == rule); }
+    REQUIRE(std::count_if(std::begin(RuleTable::propertyOf), std::end(RuleTable::propertyOf), [](EntityType rule) { return rule != NONE; }) == static_cast<long>(textEntToRule.size()));
+    REQUIRE(RuleTable::isSentence({BABA, WIN}));
+    REQUIRE(!RuleTable::isSentence({WIN, BABA}));
+}
+
+TEST_CASE("Batch simulation tests") {
+    const UserInput inputs[]{UserInput::UP, UserInput::LEFT, UserInput::LEFT, UserInput::DOWN, UserInput::RIGHT, UserInput::UP, UserInput::RESET, UserInput::DOWN, UserInput::RIGHT, UserInput::RIGHT, UserInput::UP};
+    for(const char* level : {"levels/level_0.txt", "levels/level_1.txt", "levels/level_3.txt", "levels/level_4.txt"}) {
+        Simulation::State start{Simulation::fromMap(LevelLoader::loadLevel(level))};
+        Simulation::step(start, UserInput::NONE, start);
+        const std::size_t games{37};
+        BatchSimulation batch{start, games};
+        std::vector<Simulation::State> states(games, start);
+        for(Simulation::State& state : states) { state.initial = &start; }
+
+        // Every game follows its own inputs, exactly as Simulation::step would
+        std::vector<UserInput> step(games);
+        for(unsigned tick{}; tick<120; ++tick) {
+            for(std::size_t g{}; g<games; ++g) {
+                step[g] = inputs[(tick*(g%5+1) + g + tick/(g%3+2)) % std::size(inputs)];
+                Simulation::step(states[g], step[g], states[g]);
+            }
+            batch.step(step);
+            for(std::size_t g{}; g<games; ++g) {
+                const Simulation::State state{batch.state(g)};
+                REQUIRE(state.entities.size() == states[g].entities.size());
+                for(std::size_t i{}; i<state.entities.size(); ++i) {
+                    REQUIRE(state.entities[i].type == states[g].entities[i].type);
+                    REQUIRE(state.entities[i].row == states[g].entities[i].row);
+                    REQUIRE(state.entities[i].col == states[g].entities[i].col);
+                }
+                REQUIRE(state.rules == states[g].rules);
+                REQUIRE(state.player == states[g].player);
+                REQUIRE(batch.isGameOver(g) == states[g].gameOver);
+            }
+        }
+        REQUIRE(batch.getStats().gameSteps == 120*games);
+        REQUIRE(batch.getStats().stepsPerSecond() > 0);
+        REQUIRE_THROWS_AS(batch.step({UserInput::UP}), const std::invalid_argument&);
+    }
+}
+
+TEST_CASE("Batch environment tests") {
+    // BABA IS YOU, FLAG IS WIN, and a flag two cells right of baba
+    Simulation::State tiny{3, 5, NONE, false, {}, {}, nullptr};
+    for(auto [type, row, col] : {std::tuple{TEXT_BABA, 0, 0}, {IS, 0, 1}, {YOU, 0, 2}, {TEXT_FLAG, 1, 0}, {IS, 1, 1}, {WIN, 1, 2}, {BABA, 2, 0}, {FLAG, 2, 2}})
+        tiny.entities.push_back({static_cast<std::int16_t>(row), static_cast<std::int16_t>(col), static_cast<std::uint8_t>(type), 0, 0, 0});
+    const std::vector<Simulation::State> levels{tiny, Simulation::fromMap(LevelLoader::loadLevel("levels/level_0.txt")), Simulation::fromMap(LevelLoader::loadLevel("levels/level_3.txt"))};
+
+    const std::size_t envs{7};
+    BatchEnvironment environment{levels, envs, 50, 3}, sequential{levels, envs, 50, 1};
+    REQUIRE(environment.rows() == 18);
+    REQUIRE(environment.cols() == 18);
+    std::vector<std::uint8_t> observations(environment.observationSize()), expected(sequential.observationSize());
+    std::vector<float> rewards(envs), expectedRewards(envs);
+    std::vector<std::uint8_t> dones(envs), expectedDones(envs);
+    environment.reset(observations);
+    sequential.reset(expected);
+    REQUIRE(observations == expected);
+
+    // The planes hold exactly the entities of each game
+    auto checkPlanes = [&] {
+        const std::size_t plane{environment.rows()*environment.cols()};
+        for(std::size_t env{}; env<envs; ++env) {
+            const std::uint8_t* observation{observations.data() + env*BatchEnvironment::PLANES*plane};
+            std::vector<std::uint8_t> cells(BatchEnvironment::PLANES*plane);
+            for(const Simulation::Entity& entity : environment.state(env).entities)
+                cells[entity.type*plane + entity.row*environment.cols() + entity.col] = 1;
+            REQUIRE(std::equal(cells.begin(), cells.end(), observation));
+        }
+    };
+    checkPlanes();
+
+    // Reaching the flag wins the tiny level, QUIT ends a game without reward
+    std::vector<UserInput> actions(envs, UserInput::RIGHT);
+    actions[3] = UserInput::QUIT;
+    environment.step(actions, observations, rewards, dones);
+    REQUIRE(dones[0] == 0);
+    REQUIRE(dones[3] == 1);
+    REQUIRE(rewards[3] == 0);
+    environment.step(actions, observations, rewards, dones);
+    REQUIRE(dones[0] == 1);
+    REQUIRE(rewards[0] == 1);
+    REQUIRE(environment.state(0).entities.size() == tiny.entities.size());
+    checkPlanes();
+
+    // Several threads give the same games as one
+    const UserInput inputs[]{UserInput::UP, UserInput::LEFT, UserInput::DOWN, UserInput::RIGHT, UserInput::RIGHT, UserInput::UP, UserInput::RESET};
+    environment.reset(observations);
+    for(unsigned tick{}; tick<150; ++tick) {
+        for(std::size_t env{}; env<envs; ++env) { actions[env] = inputs[(tick*(env+1) + tick/3) % std::size(inputs)]; }
+        environment.step(actions, observations, rewards, dones);
+        sequential.step(actions, expected, expectedRewards, expectedDones);
+        REQUIRE(observations == expected);
+        REQUIRE(rewards == expectedRewards);
+        REQUIRE(dones == expectedDones);
+    }
+    checkPlanes();
+    REQUIRE_THROWS_AS(environment.step(std::vector<UserInput>(1), observations, rewards, dones), const std::invalid_argument&);
+    REQUIRE_THROWS_AS(environment.reset(dones), const std::invalid_argument&);
+
+    // A level whose entities lie outside its size would write past its observation
+    Simulation::State outside{Simulation::fromMap(LevelLoader::loadLevel("tests/testmap.txt"))};
+    outside.entities.front().row = outside.rows;
+    REQUIRE_THROWS_AS(BatchEnvironment({outside}, 1), const std::invalid_argument&);
+}
+
+TEST_CASE("Transition cache tests") {
+    const UserInput inputs[]{UserInput::UP, UserInput::DOWN, UserInput::RIGHT, UserInput::LEFT, UserInput::RIGHT, UserInput::RIGHT, UserInput::UP, UserInput::RESET};
+    for(const char* level : {"levels/level_0.txt", "levels/level_3.txt"}) {
+        Simulation::State initial{Simulation::fromMap(LevelLoader::loadLevel(level))};
+        Simulation::State start{initial};
+        start.initial = &initial;
+        Simulation::step(start, UserInput::NONE, start);
+
+        // Cached steps give the same states as Simulation::step, walking back and forth hits the cache
+        for(std::size_t maxBytes : {std::size_t{64} << 20, std::size_t{8} << 10}) {
+            TransitionCache cache{maxBytes};
+            Simulation::State expected{start}, state{start}, next;
+            for(unsigned tick{}; tick<400 && !expected.gameOver; ++tick) {
+                const UserInput input{inputs[(tick + tick/5 + tick/11) % std::size(inputs)]};
+                Simulation::step(expected, input, expected);
+                if(tick % 2) { cache.step(state, input, state); }
+                else { cache.step(state, input, next); std::swap(state, next); }
+                REQUIRE(state.entities.size() == expected.entities.size());
+                for(std::size_t i{}; i<state.entities.size(); ++i) {
+                    REQUIRE(state.entities[i].type == expected.entities[i].type);
+                    REQUIRE(state.entities[i].row == expected.entities[i].row);
+                    REQUIRE(state.entities[i].col == expected.entities[i].col);
+                }
+                REQUIRE(state.rules == expected.rules);
+                REQUIRE(state.player == expected.player);
+                REQUIRE(state.gameOver == expected.gameOver);
+            }
+            REQUIRE(cache.getStats().hits > 0);
+            REQUIRE(cache.getStats().bytes <= maxBytes);
+            REQUIRE(cache.getStats().hitRate() > 0);
+        }
+    }
+
+    // A tiny cap keeps only a few transitions
+    TransitionCache cache{1};
+    Simulation::State state{Simulation::fromMap(LevelLoader::loadLevel("levels/level_0.txt"))};
+    cache.step(state, UserInput::NONE, state);
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.getStats().misses == 1);
+}
+
+TEST_CASE("C interface tests") {
+    std::ifstream file{"levels/level_0.txt"};
+    const std::string level{std::istreambuf_iterator<char>{file}, {}};
+    baba_game* game{baba_load(level.data(), level.size())};
+    REQUIRE(game != nullptr);
+    REQUIRE(baba_load("5 5\nnothing 1 1\n", 13) == nullptr);
+    REQUIRE(std::string{baba_last_error()}.size() > 0);
+
+    // The handle plays like Core
+    Core core{"levels/level_0.txt"};
+    core.update();
+    REQUIRE(baba_hash(game) == core.stateHash());
+    baba_game* clone{baba_clone(game)};
+    const int inputs[]{BABA_UP, BABA_RIGHT, BABA_RIGHT, BABA_DOWN, BABA_RESET, BABA_LEFT};
+    for(int input : inputs) {
+        REQUIRE(baba_step(game, input) == BABA_OK);
+        core.manageInput(static_cast<UserInput>(input)); core.update();
+        REQUIRE(baba_hash(game) == core.stateHash());
+        REQUIRE(baba_is_over(game) == core.isGameOver());
+    }
+    REQUIRE(baba_step(game, 42) == BABA_INVALID_ARGUMENT);
+
+    // Batch steps match single steps, the clone is independent
+    baba_game* games[]{clone, baba_clone(clone)};
+    for(int input : inputs) {
+        const int batch[]{input, input};
+        REQUIRE(baba_step_batch(games, batch, 2) == BABA_OK);
+    }
+    REQUIRE(baba_hash(games[0]) == baba_hash(game));
+    REQUIRE(baba_hash(games[1]) == baba_hash(game));
+
+    // Caller-owned buffers
+    int rows{}, cols{};
+    REQUIRE(baba_size(game, &rows, &cols) == BABA_OK);
+    REQUIRE(rows == static_cast<int>(core.getMap().size.first));
+    REQUIRE(cols == static_cast<int>(core.getMap().size.second));
+    const int count{baba_entities(game, nullptr, 0)};
+    REQUIRE(count == static_cast<int>(core.getMap().entities.size()));
+    std::vector<baba_entity> entities(count);
+    REQUIRE(baba_entities(game, entities.data(), entities.size() - 1) == BABA_BUFFER_TOO_SMALL);
+    REQUIRE(baba_entities(game, entities.data(), entities.size()) == count);
+    uint8_t types[8];
+    REQUIRE(baba_cell(game, entities[0].row, entities[0].col, types, std::size(types)) >= 1);
+    REQUIRE(types[0] == entities[0].type);
+    REQUIRE(baba_cell(game, -1, 0, types, std::size(types)) == BABA_INVALID_ARGUMENT);
+
+    for(baba_game* handle : {game, games[0], games[1]}) { baba_free(handle); }
+}
+
+TEST_CASE("Line driver tests") {
+    LineDriver driver{"levels/level_0.txt"};
+    Core core{"levels/level_0.txt"};
+    core.update();
+    std::stringstream hash; hash << std::hex << core.stateHash();
+    REQUIRE(driver.execute("hash") == hash.str());
+
+    // A batch of inputs is played like the same inputs sent to Core
+    for(UserInput input : {UserInput::RIGHT, UserInput::RIGHT, UserInput::UP, UserInput::UNDO, UserInput::LEFT}) { core.manageInput(input); core.update(); }
+    hash.str(""); hash << std::hex << core.stateHash();
+    REQUIRE(driver.execute("RRUZL") == "OK 5 "+hash.str()+" 0");
+    REQUIRE(driver.execute("dump").starts_with("18 18 72 text_wall 4 4 "));
+    REQUIRE(driver.execute("move").starts_with("ERR"));
+
+    // S is played like '.', the game ends on QUIT, reset restores the start of the level
+    const std::string paused{driver.execute(".")};
+    REQUIRE(driver.execute("S") == paused);
+    REQUIRE(driver.execute("QUU").starts_with("OK 1 "));
+    Core start{"levels/level_0.txt"};
+    start.update();
+    hash.str(""); hash << std::hex << start.stateHash();
+    REQUIRE(driver.execute("reset") == "OK 0 "+hash.str()+" 0");
+    REQUIRE(driver.execute("hash") == hash.str());
+
+    // Replies come in order, the session stops at quit
+    std::istringstream in{"R\nhash\nquit\nhash\n"};
+    std::ostringstream out;
+    driver.run(in, out);
+    const std::string replies{out.str()};
+    REQUIRE(std::count(replies.begin(), replies.end(), '\n') == 2);
+}
+
+TEST_CASE("Session host tests") {
+    const std::string path{(std::filesystem::temp_directory_path() / "baba_host_test.sock").string()};
+    SessionHost host{path, {"levels/level_0.txt", "levels/level_3.txt"}, 2};
+    std::jthread server{[&] { host.run(); }};
+    // Stops the host before the thread is joined, even when a requirement fails
+    struct Stop { SessionHost& host; ~Stop() { host.stop(); } } stop{host};
+    {
+        // Each client plays its own game, in the order of its requests
+        HostProtocol::Client first{path}, second{path};
+        Core level0{"levels/level_0.txt"}, level3{"levels/level_3.txt"};
+        level0.update(); level3.update();
+        REQUIRE(first.request(HostProtocol::HASH).hash == level0.stateHash());
+        REQUIRE(second.request(HostProtocol::HASH).hash == level3.stateHash());
+
+        const UserInput inputs[]{UserInput::RIGHT, UserInput::UP, UserInput::UP, UserInput::LEFT, UserInput::UNDO, UserInput::DOWN};
+        for(unsigned round{}; round<3; ++round) {
+            first.send(HostProtocol::INPUTS, inputs, std::size(inputs));
+            second.send(HostProtocol::INPUTS, inputs + 1, std::size(inputs) - 1);
+            for(UserInput input : inputs) { level0.manageInput(input); level0.update(); }
+            for(UserInput input : std::span{inputs}.subspan(1)) { level3.manageInput(input); level3.update(); }
+        }
+        for(unsigned round{}; round<3; ++round) {
+            REQUIRE(first.receive().played == std::size(inputs));
+            REQUIRE(second.receive().played == std::size(inputs) - 1);
+        }
+        HostProtocol::Reply reply{first.request(HostProtocol::HASH)};
+        REQUIRE(reply.hash == level0.stateHash());
+        REQUIRE(reply.entities == level0.getMap().entities.size());
+        REQUIRE(second.request(HostProtocol::HASH).hash == level3.stateHash());
+
+        // Clients can't save nor quit: such a request is rejected without playing anything
+        for(UserInput forbidden : {UserInput::SAVE, UserInput::QUIT, UserInput::NONE}) {
+            const UserInput request[]{UserInput::UP, forbidden};
+            reply = first.request(HostProtocol::INPUTS, request, std::size(request));
+            REQUIRE(reply.opcode == 0);
+            REQUIRE(reply.played == 0);
+            REQUIRE(reply.hash == level0.stateHash());
+        }
+
+        // A game can be restarted
+        reply = first.request(HostProtocol::RESTART);
+        REQUIRE(reply.gameOver == 0);
+        Core restarted{"levels/level_0.txt"};
+        restarted.update();
+        REQUIRE(reply.hash == restarted.stateHash());
+        REQUIRE(first.request(static_cast<HostProtocol::Opcode>(42)).opcode == 0);
+        REQUIRE(host.moveCount() == 3*(2*std::size(inputs) - 1));
+    }
+}
+
+TEST_CASE("Turbo replay tests") {
+    struct CountingView : View {
+        unsigned redraws{};
+        void start() const override {}
+        void update(const nvs::Subject*) override { ++redraws; }
+    };
+    std::vector<UserInput> inputs;
+    for(unsigned i{}; i<100; ++i) { inputs.push_back(static_cast<UserInput>((i*7 + i/3) % 4)); }
+    Core expected{"levels/level_0.txt"};
+    expected.update();
+    for(UserInput input : inputs) { expected.manageInput(input); expected.update(); }
+
+    // Only the final state is drawn, or every Nth input
+    for(unsigned renderEvery : {0u, 10u}) {
+        Core core{"levels/level_0.txt"};
+        CountingView view;
+        Controller controller{&core, &view};
+        controller.replay(inputs, renderEvery);
+        REQUIRE(view.redraws == (renderEvery ? inputs.size()/renderEvery + 1 : 1));
+        REQUIRE(core.stateHash() == expected.stateHash());
+        // Starting after a replay doesn't update the model again
+        controller.start();
+        REQUIRE(view.redraws == (renderEvery ? inputs.size()/renderEvery + 1 : 1));
+
+        // Notifications resume after the replay
+        controller.manageInput(UserInput::UP);
+        REQUIRE(view.redraws == (renderEvery ? inputs.size()/renderEvery + 2 : 2));
+    }
+}
+
+TEST_CASE("BFS solver tests") {
+    // The shortest solutions win when played by Core
+    for(auto [level, moves] : {std::pair{"levels/level_0.txt", 7u}, {"levels/level_2.txt", 13u}}) {
+        const Solution solution{BfsSolver{}.solve(LevelLoader::loadLevel(level))};
+        REQUIRE(solution.status == Solution::SOLVED);
+        REQUIRE(solution.inputs.size() == moves);
+        REQUIRE(solution.script().size() == moves);
+        REQUIRE(solution.stats.expanded > 0);
+        REQUIRE(solution.stats.generated == 4*solution.stats.expanded);
+        REQUIRE(solution.stats.peakBytes > 0);
+        Core core{level};
+        core.update();
+        for(UserInput input : solution.inputs) {
+            REQUIRE_FALSE(core.isGameOver());
+            core.manageInput(input); core.update();
+        }
+        REQUIRE(core.isGameOver());
+    }
+
+    // Nothing moves without a YOU rule, the limit stops the search
+    REQUIRE(BfsSolver{}.solve(LevelLoader::loadLevel("tests/testmap.txt")).status == Solution::UNSOLVABLE);
+    const Solution partial{BfsSolver{{10}}.solve(LevelLoader::loadLevel("levels/level_1.txt"))};
+    REQUIRE(partial.status == Solution::LIMIT_REACHED);
+    REQUIRE(partial.stats.expanded == 10);
+
+    // The parallel search finds exactly what the sequential one does
+    for(const char* level : {"levels/level_0.txt", "levels/level_1.txt", "levels/level_2.txt", "tests/testmap.txt"}) {
+        const Map map{LevelLoader::loadLevel(level)};
+        for(std::uint64_t limit : {std::uint64_t{10}, std::uint64_t{5000}, SolverLimits{}.maxExpanded}) {
+            const Solution sequential{BfsSolver{{limit}}.solve(map)};
+            for(std::size_t threads : {2u, 3u}) {
+                const Solution parallel{BfsSolver{{limit}, threads}.solve(map)};
+                REQUIRE(parallel.status == sequential.status);
+                REQUIRE(parallel.inputs == sequential.inputs);
+                REQUIRE(parallel.stats.expanded == sequential.stats.expanded);
+                REQUIRE(parallel.stats.generated == sequential.stats.generated);
+                REQUIRE(parallel.stats.duplicates == sequential.stats.duplicates);
+            }
+        }
+    }
+}
+
+TEST_CASE("External BFS solver tests") {
+    const std::filesystem::path directory{std::filesystem::temp_directory_path() / "baba-external-tests"};
+    std::filesystem::create_directories(directory);
+
+    // Shortest solutions, even with a buffer so small that every depth is spilled in many runs
+    for(auto [level, moves] : {std::pair{"levels/level_0.txt", 7u}, {"levels/level_1.txt", 23u}, {"levels/level_2.txt", 13u}}) {
+        const Solution solution{ExternalBfsSolver(4096, {}, directory).solve(LevelLoader::loadLevel(level))};
+        REQUIRE(solution.status == Solution::SOLVED);
+        REQUIRE(solution.inputs.size() == moves);
+        REQUIRE(solution.stats.diskBytes > 0);
+        REQUIRE(solution.stats.peakBytes < std::size_t{8} << 20);
+        Core core{level};
+        core.update();
+        for(UserInput input : solution.inputs) {
+            REQUIRE_FALSE(core.isGameOver());
+            core.manageInput(input); core.update();
+        }
+        REQUIRE(core.isGameOver());
+    }
+
+    // The same states as in memory, whatever the size of the buffer
+    const Map map{LevelLoader::loadLevel("tests/testmap.txt")};
+    const Solution inMemory{BfsSolver{}.solve(map)};
+    for(std::size_t bytes : {std::size_t{64}, std::size_t{1} << 20}) {
+        const Solution external{ExternalBfsSolver(bytes, {}, directory).solve(map)};
+        REQUIRE(external.status == Solution::UNSOLVABLE);
+        REQUIRE(external.stats.expanded == inMemory.stats.expanded);
+        REQUIRE(external.stats.duplicates == inMemory.stats.duplicates);
+    }
+    REQUIRE(ExternalBfsSolver(1 << 20, {10}, directory).solve(LevelLoader::loadLevel("levels/level_1.txt")).status == Solution::LIMIT_REACHED);
+    REQUIRE_THROWS_AS(ExternalBfsSolver(8, {}, directory).solve(LevelLoader::loadLevel("levels/level_1.txt")), const std::runtime_error&);
+
+    // Every search removes its files
+    REQUIRE(std::filesystem::is_empty(directory));
+    std::filesystem::remove(directory);
+}
+
+TEST_CASE("Dead state tests") {
+    const Simulation::State start{solverStart(LevelLoader::loadLevel("levels/level_0.txt"))};
+    REQUIRE(DeadStates::check(start) == DeadStates::ALIVE);
+    auto moveAll = [](Simulation::State& state, EntityType type, int row, int col) {
+        for(Simulation::Entity& entity : state.entities)
+            if(entity.type == type) { entity.row = row; entity.col = col; }
+    };
+
+    // Without a YOU sentence, or without an entity to move
+    Simulation::State state{start};
+    state.player = NONE;
+    REQUIRE(DeadStates::check(state) == DeadStates::NO_YOU);
+    state = start;
+    std::erase_if(state.entities, [&](const Simulation::Entity& entity) { return entity.type == start.player; });
+    REQUIRE(DeadStates::check(state) == DeadStates::NO_YOU);
+
+    // Texts stuck where they can't complete a sentence only matter without an active WIN sentence
+    state = start;
+    moveAll(state, WIN, 0, 0);
+    REQUIRE(DeadStates::check(state) == DeadStates::ALIVE);
+    std::erase_if(state.rules, [](const Sentence& rule) { return rule.second == WIN; });
+    REQUIRE(DeadStates::check(state) == DeadStates::NO_WIN_TEXT);
+    moveAll(state, WIN, 0, 5);
+    REQUIRE(DeadStates::check(state) == DeadStates::ALIVE);
+    moveAll(state, WIN, 5, 0);
+    REQUIRE(DeadStates::check(state) == DeadStates::ALIVE);
+    moveAll(state, IS, 17, 0);
+    REQUIRE(DeadStates::check(state) == DeadStates::NO_IS_TEXT);
+    moveAll(state, IS, 17, 5);
+    REQUIRE(DeadStates::check(state) == DeadStates::ALIVE);
+    for(EntityType noun : {TEXT_WALL, TEXT_ROCK, TEXT_BABA, TEXT_FLAG}) { moveAll(state, noun, 17, 17); }
+    REQUIRE(DeadStates::check(state) == DeadStates::NO_NOUN_TEXT);
+    std::erase_if(state.entities, [](const Simulation::Entity& entity) { return entity.type == WIN; });
+    REQUIRE(DeadStates::check(state) == DeadStates::NO_WIN_TEXT);
+
+    // Pruning never loses a shortest solution, and drops the states where the level is lost at once
+    for(const char* level : {"levels/level_0.txt", "levels/level_1.txt", "levels/level_2.txt"}) {
+        const Map map{LevelLoader::loadLevel(level)};
+        const Solution pruned{BfsSolver{}.solve(map)}, kept{BfsSolver{{SolverLimits{}.maxExpanded, false}}.solve(map)};
+        REQUIRE(pruned.inputs.size() == kept.inputs.size());
+        REQUIRE(pruned.stats.expanded <= kept.stats.expanded);
+        REQUIRE(kept.stats.dead == 0);
+    }
+    const Map lost{LevelLoader::loadLevel("tests/testmap.txt")};
+    for(const Solution& solution : {BfsSolver{}.solve(lost), AStarSolver{}.solve(lost), IdaStarSolver{}.solve(lost), ParallelSolver{2}.solve(lost)}) {
+        REQUIRE(solution.status == Solution::UNSOLVABLE);
+        REQUIRE(solution.stats.dead == 1);
+        REQUIRE(solution.stats.expanded == 0);
+    }
+    REQUIRE(BfsSolver{}.solve(LevelLoader::loadLevel("levels/level_2.txt")).stats.dead > 0);
+}
+
+TEST_CASE("A* and IDA* solver tests") {
+    // Heuristics
+    Simulation::State start{solverStart(LevelLoader::loadLevel("levels/level_0.txt"))};
+    REQUIRE(Heuristics::zero(start) == 0);
+    REQUIRE(Heuristics::youToWin(start) == 7);
+    REQUIRE(Heuristics::textToSlot(start) == 0);
+    REQUIRE(Heuristics::rules(start) == 7);
+    Simulation::State stuck{solverStart(LevelLoader::loadLevel("tests/testmap.txt"))};
+    REQUIRE(Heuristics::textToSlot(stuck) == Heuristics::UNREACHABLE);
+    stuck.player = NONE;
+    REQUIRE(Heuristics::rules(stuck) == Heuristics::UNREACHABLE);
+
+    // The IS texts created by FLAG IS IS turn the flag between ROCK and WIN into an IS: the game is won in
+    // two moves, although the WIN text is far from every IS text of the start
+    const std::string createdIs{(std::filesystem::temp_directory_path() / "baba_created_is.txt").string()};
+    std::ofstream{createdIs} << "10 10\ntext_baba 0 0\nis 1 0\nyou 2 0\ntext_rock 0 4\nflag 1 4\nwin 2 4\n"
+        "text_flag 4 2\nis 5 2\nis 7 2\nbaba 8 2\nrock 7 3\n";
+
+    // The admissible heuristics never overestimate the moves left along a shortest solution
+    for(const std::string& level : {std::string{"levels/level_1.txt"}, std::string{"levels/level_2.txt"}, createdIs}) {
+        Simulation::State state{solverStart(LevelLoader::loadLevel(level))}, next;
+        const Solution solution{BfsSolver{}.solve(state)};
+        REQUIRE(solution.status == Solution::SOLVED);
+        for(std::size_t played{}; played<solution.inputs.size(); ++played) {
+            REQUIRE(Heuristics::rules(state) <= solution.inputs.size() - played);
+            REQUIRE(Heuristics::textToSlot(state) <= solution.inputs.size() - played);
+            Simulation::step(state, solution.inputs[played], next);
+            std::swap(state, next);
+        }
+    }
+
+    // A win is only accepted once no shorter solution is left: the heuristics are 0 on most states here,
+    // where winning moves are generated before the shortest solution is complete
+    const std::string earlyWin{(std::filesystem::temp_directory_path() / "baba_early_win.txt").string()};
+    std::ofstream{earlyWin} << "6 6\ntext_baba 0 0\nis 1 0\nyou 2 0\nbaba 3 3\nflag 3 1\nbaba 0 3\nflag 4 2\n"
+        "text_baba 1 4\ntext_wall 5 4\nis 2 4\nis 0 1\nwin 4 1\ntext_baba 4 4\nwin 4 5\n";
+    for(const std::string& level : {earlyWin, createdIs}) {
+        const Map map{LevelLoader::loadLevel(level)};
+        const std::size_t shortest{BfsSolver{}.solve(map).inputs.size()};
+        for(const auto& [name, heuristic] : Heuristics::all) {
+            if(heuristic == Heuristics::youToWin) { continue; }
+            REQUIRE(AStarSolver{heuristic}.solve(map).inputs.size() == shortest);
+            REQUIRE(IdaStarSolver{heuristic}.solve(map).inputs.size() == shortest);
+        }
+    }
+    REQUIRE(BfsSolver{}.solve(LevelLoader::loadLevel(earlyWin)).inputs.size() == 7);
+
+    // Every heuristic finds a shortest solution here, the informed ones expanding fewer states
+    for(auto [level, moves] : {std::pair{"levels/level_0.txt", 7u}, {"levels/level_2.txt", 13u}}) {
+        const Map map{LevelLoader::loadLevel(level)};
+        const Solution uninformed{AStarSolver{Heuristics::zero}.solve(map)};
+        for(const auto& [name, heuristic] : Heuristics::all) {
+            for(const Solution& solution : {AStarSolver{heuristic}.solve(map), IdaStarSolver{heuristic}.solve(map)}) {
+                REQUIRE(solution.status == Solution::SOLVED);
+                REQUIRE(solution.inputs.size() == moves);
+                Core core{level};
+                core.update();
+                for(UserInput input : solution.inputs) { core.manageInput(input); core.update(); }
+                REQUIRE(core.isGameOver());
+            }
+        }
+        REQUIRE(AStarSolver{Heuristics::rules}.solve(map).stats.expanded < uninformed.stats.expanded);
+    }
+
+    REQUIRE(AStarSolver{}.solve(LevelLoader::loadLevel("tests/testmap.txt")).status == Solution::UNSOLVABLE);
+    REQUIRE(IdaStarSolver{}.solve(LevelLoader::loadLevel("tests/testmap.txt")).status == Solution::UNSOLVABLE);
+    REQUIRE(IdaStarSolver(Heuristics::zero, {100}).solve(LevelLoader::loadLevel("levels/level_1.txt")).status == Solution::LIMIT_REACHED);
+}
+
+TEST_CASE("Macro-move solver tests") {
+    // The inputs of each macro-move lead, played one by one, to the state it reaches
+    const Simulation::State start{solverStart(LevelLoader::loadLevel("levels/level_1.txt"))};
+    MacroMoves macroMoves;
+    Simulation::State child, played, next;
+    std::vector<UserInput> inputs;
+    std::size_t count{};
+    macroMoves.expand(start, child, inputs, [&] {
+        ++count;
+        played = start;
+        for(UserInput input : inputs) { Simulation::step(played, input, next); std::swap(played, next); }
+        REQUIRE(Simulation::hash(played) == Simulation::hash(child));
+        REQUIRE(played.gameOver == child.gameOver);
+    });
+    REQUIRE(count > std::size(solverMoves));
+
+    // The solutions stay the shortest ones, found in fewer steps and expansions than with primitive moves
+    for(auto [level, moves] : {std::pair{"levels/level_0.txt", 7u}, {"levels/level_1.txt", 23u}, {"levels/level_2.txt", 13u}}) {
+        const Map map{LevelLoader::loadLevel(level)};
+        const Solution solution{MacroSolver{}.solve(map)};
+        REQUIRE(solution.status == Solution::SOLVED);
+        REQUIRE(solution.inputs.size() == moves);
+        REQUIRE(solution.stats.depth < moves);
+        REQUIRE(solution.stats.expanded < AStarSolver{}.solve(map).stats.expanded);
+        Core core{level};
+        core.update();
+        for(UserInput input : solution.inputs) { core.manageInput(input); core.update(); }
+        REQUIRE(core.isGameOver());
+    }
+
+    // Walking is no longer free once FLAG IS IS turned the flag between ROCK and WIN into an IS: the rock
+    // walked onto wins at once
+    const std::string createdIs{(std::filesystem::temp_directory_path() / "baba_macro_created_is.txt").string()};
+    std::ofstream{createdIs} << "10 10\ntext_baba 0 0\nis 1 0\nyou 2 0\ntext_rock 0 4\nflag 1 4\nwin 2 4\n"
+        "text_flag 4 2\nis 5 2\nis 7 2\nbaba 8 2\nrock 7 3\n";
+    for(const auto& [name, heuristic] : Heuristics::all)
+        if(heuristic != Heuristics::youToWin) { REQUIRE(MacroSolver{heuristic}.solve(LevelLoader::loadLevel(createdIs)).inputs.size() == 2); }
+
+    REQUIRE(MacroSolver{}.solve(LevelLoader::loadLevel("tests/testmap.txt")).status == Solution::UNSOLVABLE);
+    REQUIRE(MacroSolver(Heuristics::rules, {10}).solve(LevelLoader::loadLevel("levels/level_1.txt")).status == Solution::LIMIT_REACHED);
+}
+
+TEST_CASE("Packed state tests") {
+    auto sameState = [](const Simulation::State& lhs, const Simulation::State& rhs) {
+        if(lhs.player != rhs.player || lhs.rules != rhs.rules || lhs.entities.size() != rhs.entities.size()) { return false; }
+        for(std::size_t i{}; i<lhs.entities.size(); ++i)
+            if(lhs.entities[i].row != rhs.entities[i].row || lhs.entities[i].col != rhs.entities[i].col || lhs.entities[i].type != rhs.entities[i].type)
+                return false;
+        return true;
+    };
+
+    // States met while playing decode to themselves and play on the same way
+    const std::string script{"URULLUULLDDDUURDDRDLLLR"};
+    for(const char* level : {"levels/level_0.txt", "levels/level_1.txt", "levels/level_2.txt", "levels/level_3.txt"}) {
+        const Simulation::State start{solverStart(LevelLoader::loadLevel(level))};
+        Simulation::State state{start}, decoded{start}, next, decodedNext;
+        std::vector<std::uint8_t> packed;
+        PackedState::encode(start, start, packed);
+        REQUIRE(packed.size() < 3 + start.rules.size()*2 + start.entities.size()/2);
+        for(std::size_t i{}; i<200; ++i) {
+            PackedState::encode(state, start, packed);
+            PackedState::decode(packed, start, decoded);
+            REQUIRE(sameState(decoded, state));
+            const UserInput input{i < script.size() ? charToInput(script[i]) : solverMoves[(i*i*31 + i*7) % 11 % 4]};
+            Simulation::step(state, input, next);
+            Simulation::step(decoded, input, decodedNext);
+            REQUIRE(sameState(decodedNext, next));
+            if(next.gameOver) { break; }
+            std::swap(state, next);
+        }
+    }
+
+    // Removed entities, even many in a row, and changed ones
+    const Simulation::State start{solverStart(LevelLoader::loadLevel("levels/level_1.txt"))};
+    Simulation::State state{start}, decoded{start};
+    state.entities.erase(state.entities.begin() + 3, state.entities.begin() + 15);
+    state.entities.erase(state.entities.begin());
+    state.entities[20].type = ROCK;
+    state.entities[30].col = 0;
+    state.entities.pop_back();
+    std::vector<std::uint8_t> packed;
+    PackedState::encode(state, start, packed);
+    PackedState::decode(packed, start, decoded);
+    REQUIRE(sameState(decoded, state));
+
+    // The table tells encodings apart exactly and keeps them while growing
+    PackedStateTable table{4};
+    REQUIRE(table.insert(packed) == std::pair(0u, true));
+    REQUIRE(table.insert(packed) == std::pair(0u, false));
+    REQUIRE(std::ranges::equal(table.get(0), packed));
+    REQUIRE(table.insert(packed, 42) == std::pair(1u, true));
+    for(std::uint32_t i{}; i<10000; ++i) {
+        const std::uint8_t bytes[]{static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i >> 8)};
+        REQUIRE(table.insert(bytes).first == i + 2);
+    }
+    REQUIRE(table.size() == 10002);
+    for(std::uint32_t i{}; i<10000; ++i) {
+        const std::uint8_t bytes[]{static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i >> 8)};
+        REQUIRE(table.insert(bytes) == std::pair(i + 2, false));
+        REQUIRE(std::ranges::equal(table.get(i + 2), bytes));
+    }
+    REQUIRE(table.bytes() > 10002*2);
+}
+
+TEST_CASE("Parallel solver tests") {
+    // Concurrent insertions of overlapping hashes insert each hash once
+    VisitedTable table{1 << 12};
+    std::atomic<unsigned> inserted{};
+    {
+        std::vector<std::jthread> threads;
+        for(unsigned t{}; t<4; ++t)
+            threads.emplace_back([&, t] {
+                for(std::uint64_t key{}; key<2000; ++key)
+                    if(table.insert(Zobrist::mix(key + t%2)) == VisitedTable::INSERTED) { ++inserted; }
+            });
+    }
+    REQUIRE(inserted == 2001);
+    REQUIRE(table.size() == 2001);
+    REQUIRE(table.insert(Zobrist::mix(0)) == VisitedTable::FOUND);
+    VisitedTable small{8};
+    for(std::uint64_t key{1}; key<=7; ++key) { REQUIRE(small.insert(key) == VisitedTable::INSERTED); }
+    REQUIRE(small.insert(3) == VisitedTable::FOUND);
+    REQUIRE(small.insert(100) == VisitedTable::FULL);
+    REQUIRE(small.size() == 7);
+    REQUIRE(VisitedTable{1000}.capacity() == 1024);
+
+    // The solutions found win when played by Core
+    for(const char* level : {"levels/level_0.txt", "levels/level_1.txt", "levels/level_2.txt"}) {
+        for(std::size_t threads : {1u, 3u}) {
+            const Solution solution{ParallelSolver{threads}.solve(LevelLoader::loadLevel(level))};
+            REQUIRE(solution.status == Solution::SOLVED);
+            REQUIRE(solution.stats.expanded > 0);
+            Core core{level};
+            core.update();
+            for(UserInput input : solution.inputs) {
+                REQUIRE_FALSE(core.isGameOver());
+                core.manageInput(input); core.update();
+            }
+            REQUIRE(core.isGameOver());
+        }
+    }
+    REQUIRE(ParallelSolver{2}.solve(LevelLoader::loadLevel("tests/testmap.txt")).status == Solution::UNSOLVABLE);
+    REQUIRE(ParallelSolver(2, Heuristics::rules, {50}).solve(LevelLoader::loadLevel("levels/level_3.txt")).status == Solution::LIMIT_REACHED);
+}
+
 int main() {
 	Catch::Session().run();
     return 0;
@@ -0,0 +1,57 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    if(!threads) { threads = std::max(1u, std::thread::hardware_concurrency()); }
+    _workers.reserve(threads - 1);
+    for(std::size_t i{1}; i<threads; ++i)
+        _workers.emplace_back(&ThreadPool::run, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock{_mutex};
+        _stopping = true;
+    }
+    _started.notify_all();
+    for(std::thread& worker : _workers) { worker.join(); }
+}
+
+void ThreadPool::run() {
+    std::uint64_t done{};
+    std::unique_lock lock{_mutex};
+    while(true) {
+        _started.wait(lock, [&] { return _stopping || _generation != done; });
+        if(_stopping) { return; }
+        done = _generation;
+        lock.unlock();
+        work();
+        lock.lock();
+        if(--_running == 0) { _finished.notify_one(); }
+    }
+}
+
+void ThreadPool::work() {
+    for(std::size_t begin{_next.fetch_add(_chunk)}; begin < _count; begin = _next.fetch_add(_chunk))
+        _job(_function, begin, std::min(begin + _chunk, _count));
+}
+
+void ThreadPool::parallelFor(std::size_t count, void* function, Job job) {
+    if(!count) { return; }
+    if(_workers.empty()) { job(function, 0, count); return; }
+    {
+        std::lock_guard lock{_mutex};
+        _job = job;
+        _function = function;
+        _count = count;
+        // A few chunks per thread, so that a slow chunk doesn't hold the others back
+        _chunk = std::max<std::size_t>(1, count / (4*size()));
+        _next = 0;
+        _running = _workers.size();
+        ++_generation;
+    }
+    _started.notify_all();
+    work();
+    std::unique_lock lock{_mutex};
+    _finished.wait(lock, [this] { return _running == 0; });
+}
@@ -0,0 +1,76 @@
+/**
+    @file ThreadPool.h
+    @brief Defines the ThreadPool class, which runs parallel loops on a fixed set of worker threads.
+*/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+    @brief Runs parallel loops on worker threads started once.
+    @details The calling thread takes part in every loop. A loop only publishes a pointer to the
+    callable, so running one never allocates; its iterations are handed out in chunks through an
+    atomic counter. Loops must be started from one thread at a time and their body must not throw.
+*/
+class ThreadPool {
+    using Job = void (*)(void* function, std::size_t begin, std::size_t end);
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _started;
+    std::condition_variable _finished;
+    Job _job{};
+    void* _function{};
+    std::size_t _count{};
+    std::size_t _chunk{};
+    std::atomic<std::size_t> _next{};
+    std::size_t _running{};
+    std::uint64_t _generation{};
+    bool _stopping{};
+
+    void run();
+    void work();
+    void parallelFor(std::size_t count, void* function, Job job);
+public:
+    /**
+        @brief Starts the worker threads.
+        @param threads The number of threads running a loop, the calling one included; 0 uses every core.
+    */
+    explicit ThreadPool(std::size_t threads = 0);
+    /**
+        @brief Stops the worker threads.
+    */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+        @brief Gets the number of threads running a loop, the calling one included.
+        @return The number of threads.
+    */
+    std::size_t size() const { return _workers.size() + 1; }
+
+    /**
+        @brief Calls function(begin, end) over disjoint ranges covering [0, count), and waits for all of them.
+        @param count The number of iterations.
+        @param function The body of the loop, called concurrently with disjoint ranges.
+    */
+    template<class Function>
+    void parallelFor(std::size_t count, Function&& function) {
+        parallelFor(count, &function, [](void* function, std::size_t begin, std::size_t end) {
+            (*static_cast<std::remove_reference_t<Function>*>(function))(begin, end);
+        });
+    }
+};
+
+#endif // THREADPOOL_H
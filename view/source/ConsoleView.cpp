@@ -39,6 +39,8 @@ UserInput ConsoleView::getUserInput() const {
         case KEY_LEFT: return UserInput::LEFT;
         case KEY_RIGHT: return UserInput::RIGHT;
         case 'r': return UserInput::RESET;
+        case 'z': return UserInput::UNDO;
+        case 'y': return UserInput::REDO;
         case 's': return UserInput::SAVE;
         case 'q': return UserInput::QUIT;
         default: return UserInput::NONE;
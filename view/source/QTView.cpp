@@ -19,6 +19,8 @@ void Window::keyPressEvent(QKeyEvent* evt) {
         case Qt::Key_Right: _controller->manageInput(UserInput::RIGHT); break;
         case Qt::Key_Left: _controller->manageInput(UserInput::LEFT); break;
         case Qt::Key_R: _controller->manageInput(UserInput::RESET); break;
+        case Qt::Key_Z: _controller->manageInput(UserInput::UNDO); break;
+        case Qt::Key_Y: _controller->manageInput(UserInput::REDO); break;
         case Qt::Key_Q: _controller->manageInput(UserInput::QUIT); break;
         case Qt::Key_S: _controller->manageInput(UserInput::SAVE); break;
     }